@@ -0,0 +1,634 @@
+#include "Benchmark.h"
+#include "System.h"
+#include "Process.h"
+#include "KernelSystem.h"
+#include "ClusterAllocator.h"
+#include "MemoryException.h"
+#include "part.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#define ACCESS_BLOCK 64 //Pogodak traje koliko i merenje vremena, pa se meri blok pristupa
+#define SEGMENT_PAGES 64 //Velicina segmenata koji se kreiraju, ucitavaju, brisu i dele
+#define CLONE_COUNT 8 //Klonovi koji postoje istovremeno pri merenju zauzeca memorije
+#define CHURN_SLOTS 16 //Segmenti u segment_churn pocinju na pocetku PMT-a drugog nivoa, poslednja cetiri mesta su za deljene segmente
+#define CHURN_SHARED_SLOTS 4
+#define CHURN_SHARED_NAMES 8
+
+const char* const Benchmark::cases[] = {
+	"access_hit",
+	"page_fault_clean",
+	"page_fault_dirty",
+	"create_segment",
+	"load_segment",
+	"delete_segment",
+	"clone_process",
+	"clone_write",
+	"shared_segment_attach",
+	"swap_page",
+	"segment_churn",
+	"cluster_allocate_run",
+	"cluster_free_run",
+	"threaded_access",
+	nullptr
+};
+
+static inline unsigned long long now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Benchmark::Benchmark(Partition* partition, unsigned int partitionFlags, const SystemConfig& config, PageNum pmtPages, unsigned int warmup, unsigned int samples)
+	: partition(partition), partitionFlags(partitionFlags), config(config), pmtPages(pmtPages), warmup(warmup), samples(samples), system(nullptr), vmSpace(nullptr), pmtSpace(nullptr), seed(0) {
+}
+
+bool Benchmark::hasCase(const char* name) const {
+	for (int i = 0; cases[i] != nullptr; i++) {
+		if (std::strcmp(cases[i], name) == 0) return true;
+	}
+	return false;
+}
+
+static inline unsigned long long xorshift(unsigned long long& state) {
+	state ^= state << 13;
+	state ^= state >> 7;
+	state ^= state << 17;
+	return state;
+}
+
+unsigned long long Benchmark::random() {
+	return xorshift(this->seed);
+}
+
+void Benchmark::createSystem(PageNum frames) {
+	this->vmSpace = new char[(frames + 1) * PAGE_SIZE];
+	this->pmtSpace = new char[(this->pmtPages + 1) * PAGE_SIZE];
+
+	PhysicalAddress vm = (PhysicalAddress)(((size_t)this->vmSpace + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE);
+	PhysicalAddress pmt = (PhysicalAddress)(((size_t)this->pmtSpace + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE);
+
+	this->system = new System(vm, frames, pmt, this->pmtPages, this->partition, this->config);
+	this->seed = 88172645463325252ULL;
+}
+
+void Benchmark::deleteSystem() {
+	for (Process* process : this->processes) delete process;
+	this->processes.clear();
+
+	delete this->system;
+	delete[] this->vmSpace;
+	delete[] this->pmtSpace;
+	this->system = nullptr;
+}
+
+void Benchmark::createProcesses(unsigned int count) {
+	for (unsigned int i = 0; i < count; i++) this->processes.push_back(this->system->createProcess());
+}
+
+BenchmarkResult Benchmark::run(const char* name, PageNum frames, unsigned int processes) {
+	BenchmarkResult result;
+	result.name = name;
+	result.frames = frames;
+	result.processes = processes;
+	result.unit = "call";
+
+	this->createSystem(frames);
+	this->createProcesses(processes);
+
+	if (result.name == "access_hit") this->accessHit(result);
+	else if (result.name == "page_fault_clean") this->pageFault(result, false);
+	else if (result.name == "page_fault_dirty") this->pageFault(result, true);
+	else if (result.name == "create_segment" || result.name == "load_segment" || result.name == "delete_segment") this->segment(result, name);
+	else if (result.name == "clone_process") this->cloneProcess(result);
+	else if (result.name == "clone_write") this->cloneWrite(result);
+	else if (result.name == "shared_segment_attach") this->sharedSegmentAttach(result);
+	else if (result.name == "swap_page") this->swapPage(result);
+	else if (result.name == "segment_churn") this->segmentChurn(result);
+	else if (result.name == "cluster_allocate_run" || result.name == "cluster_free_run") this->clusterAllocator(result, result.name == "cluster_free_run");
+	else if (result.name == "threaded_access") this->threadedAccess(result);
+
+	this->deleteSystem();
+
+	return result;
+}
+
+bool Benchmark::createSegments(BenchmarkResult& result, PageNum pages) {
+	if (pages == 0) {
+		result.skipped = "manje frejmova nego procesa";
+		return false;
+	}
+
+	for (Process* process : this->processes) {
+		if (process->createSegment(0, pages, READ_WRITE, true) != OK) {
+			result.skipped = "segment ne moze da se kreira";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Benchmark::accessHit(BenchmarkResult& result) {
+	result.unit = "access";
+
+	//Segmenti svih procesa zauzimaju pola memorije i ucitavaju se pri kreiranju
+	PageNum pages = result.frames / (2 * this->processes.size());
+	if (!this->createSegments(result, pages)) return;
+
+	std::vector<std::pair<ProcessId, VirtualAddress>> addresses(ACCESS_BLOCK);
+
+	for (unsigned int sample = 0; sample < this->warmup + this->samples; sample++) {
+		for (auto& address : addresses) {
+			address.first = this->processes[this->random() % this->processes.size()]->getProcessId();
+			address.second = this->random() % (pages * PAGE_SIZE);
+		}
+
+		unsigned long long start = now();
+		for (auto& address : addresses) {
+			if (this->system->access(address.first, address.second, (address.second & 1) ? WRITE : READ) != OK) {
+				result.skipped = "pristup stranici u memoriji nije vratio OK";
+				return;
+			}
+		}
+		unsigned long long time = now() - start;
+
+		if (sample >= this->warmup) result.samples.push_back((double)time / ACCESS_BLOCK);
+	}
+}
+
+void Benchmark::pageFault(BenchmarkResult& result, bool dirty) {
+	//Stranice svih procesa su za cetvrtinu vece od memorije i pristupaju se redom, pa skoro svaki pristup izbacuje stranicu.
+	//Sadrzaj ucitanog segmenta je na disku i nije menjan, a stranice kreiranog segmenta se menjaju pa se upisuju pri izbacivanju.
+	PageNum pages = (result.frames + result.frames / 4) / this->processes.size();
+
+	if (pages * this->processes.size() > this->partition->getNumOfClusters()) {
+		result.skipped = "particija nema dovoljno klastera";
+		return;
+	}
+	if (pages > (VIRTUAL_MEMORY_LAST_ADDRESS + 1) / PAGE_SIZE) {
+		result.skipped = "segment je veci od virtuelnog adresnog prostora";
+		return;
+	}
+
+	std::vector<char> content(pages * PAGE_SIZE, 1);
+
+	for (Process* process : this->processes) {
+		Status status = dirty ? process->createSegment(0, pages, READ_WRITE) : process->loadSegment(0, pages, READ_WRITE, content.data());
+		if (status != OK) {
+			result.skipped = "segment ne moze da se kreira";
+			return;
+		}
+	}
+
+	this->faultLoop(result, pages, dirty ? WRITE : READ, false); //Prvi prolaz puni memoriju
+	this->faultLoop(result, pages, dirty ? WRITE : READ, true);
+}
+
+void Benchmark::faultLoop(BenchmarkResult& result, PageNum pagesPerProcess, AccessType type, bool measure) {
+	PageNum total = pagesPerProcess * this->processes.size();
+	PageNum accesses = 0;
+	unsigned int faults = 0;
+
+	for (PageNum i = 0; measure ? faults < this->warmup + this->samples : i < total; i++) {
+		Process* process = this->processes[(i % total) / pagesPerProcess];
+		VirtualAddress address = (i % pagesPerProcess) * PAGE_SIZE;
+
+		if (++accesses > 10 * total && faults == 0) { //Sve stranice su stale u memoriju
+			result.skipped = "pristupi ne izazivaju page fault";
+			return;
+		}
+
+		if (this->system->access(process->getProcessId(), address, type) != PAGE_FAULT) continue;
+
+		unsigned long long start = now();
+		Status status = process->pageFault(address);
+		unsigned long long time = now() - start;
+
+		if (status != OK || this->system->access(process->getProcessId(), address, type) != OK) {
+			result.skipped = "page fault nije uspeo";
+			return;
+		}
+
+		if (measure && faults++ >= this->warmup) result.samples.push_back((double)time);
+	}
+}
+
+void Benchmark::segment(BenchmarkResult& result, const char* operation) {
+	result.unit = "page";
+
+	bool load = std::strcmp(operation, "create_segment") != 0;
+	bool measureDelete = std::strcmp(operation, "delete_segment") == 0;
+
+	//Brise se ucitan segment, cije stranice imaju klastere na disku
+	std::vector<char> content(SEGMENT_PAGES * PAGE_SIZE, 1);
+
+	for (unsigned int sample = 0; sample < this->warmup + this->samples; sample++) {
+		Process* process = this->processes[sample % this->processes.size()];
+
+		unsigned long long start = now();
+		Status status = load ? process->loadSegment(0, SEGMENT_PAGES, READ_WRITE, content.data()) : process->createSegment(0, SEGMENT_PAGES, READ_WRITE);
+		unsigned long long time = now() - start;
+
+		start = now();
+		if (status == OK) status = process->deleteSegment(0);
+		unsigned long long deleteTime = now() - start;
+
+		if (status != OK) {
+			result.skipped = "segment ne moze da se kreira ili obrise";
+			return;
+		}
+
+		if (sample >= this->warmup) result.samples.push_back((double)(measureDelete ? deleteTime : time) / SEGMENT_PAGES);
+	}
+}
+
+void Benchmark::cloneProcess(BenchmarkResult& result) {
+	result.unit = "page";
+
+	//Proces koji se kopira ima pola memorije podeljeno na sve procese, ucitano pri kreiranju segmenta
+	PageNum pages = result.frames / (2 * this->processes.size());
+	if (!this->createSegments(result, pages)) return;
+
+	for (unsigned int sample = 0; sample < this->warmup + this->samples; sample++) {
+		Process* process = this->processes[sample % this->processes.size()];
+
+		unsigned long long start = now();
+		Process* clone = this->system->cloneProcess(process->getProcessId());
+		unsigned long long time = now() - start;
+
+		if (clone == nullptr) {
+			result.skipped = "cloneProcess nije uspeo";
+			return;
+		}
+		delete clone;
+
+		if (sample >= this->warmup) result.samples.push_back((double)time / pages);
+	}
+
+	//Klonovi dele frejmove sa roditeljem, a zauzimaju pmtSpace za svoje tabele i deskriptore deljenih stranica
+	SystemStats before = this->system->getStats();
+
+	std::vector<Process*> clones;
+	for (unsigned int i = 0; i < CLONE_COUNT; i++) {
+		Process* clone = this->system->cloneProcess(this->processes[i % this->processes.size()]->getProcessId());
+		if (clone != nullptr) clones.push_back(clone);
+	}
+
+	SystemStats after = this->system->getStats();
+
+	for (Process* clone : clones) delete clone;
+
+	result.metrics.push_back({ "clones", clones.size() });
+	result.metrics.push_back({ "framesUsedBefore", before.totalFrames - before.freeFrames });
+	result.metrics.push_back({ "framesUsedAfter", after.totalFrames - after.freeFrames });
+	result.metrics.push_back({ "pmtSpaceUsedBefore", before.pmtSpaceUsed });
+	result.metrics.push_back({ "pmtSpaceUsedAfter", after.pmtSpaceUsed });
+}
+
+void Benchmark::cloneWrite(BenchmarkResult& result) {
+	//Roditelji zauzimaju pola memorije, a klon koji upisuje u sve stranice drugu polovinu, pa kopiranje ne izbacuje stranice
+	PageNum pages = result.frames / (2 * this->processes.size());
+	if (!this->createSegments(result, pages)) return;
+
+	for (unsigned int sample = 0, round = 0; sample < this->warmup + this->samples; round++) {
+		SystemStats before = this->system->getStats();
+
+		Process* clone = this->system->cloneProcess(this->processes[round % this->processes.size()]->getProcessId());
+		if (clone == nullptr) {
+			result.skipped = "cloneProcess nije uspeo";
+			return;
+		}
+
+		SystemStats cloned = this->system->getStats();
+
+		for (PageNum page = 0; page < pages && sample < this->warmup + this->samples; page++) {
+			VirtualAddress address = page * PAGE_SIZE;
+
+			if (this->system->access(clone->getProcessId(), address, WRITE) != PAGE_FAULT) continue;
+
+			unsigned long long start = now();
+			Status status = clone->pageFault(address);
+			unsigned long long time = now() - start;
+
+			if (status != OK || this->system->access(clone->getProcessId(), address, WRITE) != OK) {
+				delete clone;
+				result.skipped = "kopiranje stranice pri upisu nije uspelo";
+				return;
+			}
+
+			if (sample++ >= this->warmup) result.samples.push_back((double)time);
+		}
+
+		if (round == 0) { //Zauzece memorije za klon pre i posle upisa u sve stranice
+			SystemStats written = this->system->getStats();
+
+			result.metrics.push_back({ "framesUsedBefore", before.totalFrames - before.freeFrames });
+			result.metrics.push_back({ "framesUsedAfterClone", cloned.totalFrames - cloned.freeFrames });
+			result.metrics.push_back({ "framesUsedAfterWrite", written.totalFrames - written.freeFrames });
+			result.metrics.push_back({ "pmtSpaceUsedBefore", before.pmtSpaceUsed });
+			result.metrics.push_back({ "pmtSpaceUsedAfterClone", cloned.pmtSpaceUsed });
+			result.metrics.push_back({ "pmtSpaceUsedAfterWrite", written.pmtSpaceUsed });
+		}
+
+		delete clone;
+	}
+}
+
+void Benchmark::sharedSegmentAttach(BenchmarkResult& result) {
+	//Prvi proces kreira deljeni segment, a ostali se redom povezuju sa njim i odmah odvajaju
+	Process* owner = this->system->createProcess();
+	this->processes.push_back(owner);
+
+	if (owner->createSharedSegment(0, SEGMENT_PAGES, "benchmark", READ_WRITE) != OK) {
+		result.skipped = "deljeni segment ne moze da se kreira";
+		return;
+	}
+
+	for (unsigned int sample = 0; sample < this->warmup + this->samples; sample++) {
+		Process* process = this->processes[sample % (this->processes.size() - 1)];
+
+		unsigned long long start = now();
+		Status status = process->createSharedSegment(0, SEGMENT_PAGES, "benchmark", READ_WRITE);
+		unsigned long long time = now() - start;
+
+		if (status != OK || process->disconnectSharedSegment("benchmark") != OK) {
+			result.skipped = "povezivanje sa deljenim segmentom nije uspelo";
+			return;
+		}
+
+		if (sample >= this->warmup) result.samples.push_back((double)time);
+	}
+}
+
+void Benchmark::swapPage(BenchmarkResult& result) {
+	//Stranice procesa zauzimaju celu memoriju. swapPage se poziva direktno dok ne izbaci pola stranica, frejm koji vrati
+	//se oslobadja, a izbacene stranice se zatim ponovo ucitavaju.
+	PageNum pages = result.frames / this->processes.size();
+	if (!this->createSegments(result, pages)) return;
+
+	KernelSystem* kernelSystem = KernelSystem::kernelSystem;
+	PageNum calls = result.frames / (2 * std::max<PageNum>(this->config.swapBatchSize, 1));
+	if (calls == 0) calls = 1;
+
+	for (unsigned int sample = 0; sample < this->warmup + this->samples; ) {
+		for (PageNum i = 0; i < calls && sample < this->warmup + this->samples; i++, sample++) {
+			unsigned long long start = now();
+			PhysicalAddress frame = kernelSystem->swapPage();
+			unsigned long long time = now() - start;
+
+			kernelSystem->deallocatePage(frame);
+
+			if (sample >= this->warmup) result.samples.push_back((double)time);
+		}
+
+		for (Process* process : this->processes) {
+			for (PageNum page = 0; page < pages; page++) {
+				VirtualAddress address = page * PAGE_SIZE;
+
+				if (this->system->access(process->getProcessId(), address, READ) == PAGE_FAULT && process->pageFault(address) != OK) {
+					result.skipped = "page fault nije uspeo";
+					return;
+				}
+			}
+		}
+	}
+}
+
+void Benchmark::clusterAllocator(BenchmarkResult& result, bool measureFree) {
+	ClusterNo clusters = this->partition->getNumOfClusters();
+
+	if (clusters < 4 * SUPERPAGE_SIZE) {
+		result.skipped = "particija nema dovoljno klastera";
+		return;
+	}
+
+	//Alokator se pravi direktno, bez sistema, pa se meri samo njegovo vreme bez zakljucavanja
+	ClusterAllocator allocator(clusters);
+	std::vector<std::pair<ClusterNo, ClusterNo>> runs; //Alocirani nizovi, (prvi klaster, broj klastera)
+	unsigned long failures = 0;
+
+	for (unsigned int sample = 0; sample < this->warmup + this->samples; ) {
+		//Vecina nizova su pojedinacne stranice, ostali su nizovi stranica i velike stranice
+		unsigned long long kind = this->random() % 8;
+		ClusterNo count = (kind < 5) ? 1 : (kind < 7) ? 2 + this->random() % 15 : SUPERPAGE_SIZE;
+
+		bool allocate = allocator.getFreeClusters() > clusters / 4 || runs.empty();
+
+		if (allocate) {
+			unsigned long long start = now();
+			ClusterNo first = 0;
+			bool allocated = true;
+			try {
+				first = allocator.allocateRun(count);
+			}
+			catch (const MemoryException&) { //Nema dovoljno dugog niza, particija je fragmentisana
+				allocated = false;
+			}
+			unsigned long long time = now() - start;
+
+			if (allocated) runs.push_back({ first, count });
+			else ++failures;
+
+			if (!measureFree && sample++ >= this->warmup) result.samples.push_back((double)time);
+
+			if (allocated || allocator.getFreeClusters() > clusters / 4) continue;
+		}
+
+		//Oslobadja se slucajan niz, pa slobodan prostor ostaje isprekidan
+		size_t index = this->random() % runs.size();
+		std::pair<ClusterNo, ClusterNo> run = runs[index];
+		runs[index] = runs.back();
+		runs.pop_back();
+
+		unsigned long long start = now();
+		allocator.freeRun(run.first, run.second);
+		unsigned long long time = now() - start;
+
+		if (measureFree && sample++ >= this->warmup) result.samples.push_back((double)time);
+	}
+
+	result.metrics.push_back({ "allocationFailures", failures });
+	result.metrics.push_back({ "freeClusters", allocator.getFreeClusters() });
+	result.metrics.push_back({ "freeExtents", allocator.getNumberOfExtents() });
+	result.metrics.push_back({ "largestRun", allocator.getLargestRun() });
+}
+
+void Benchmark::segmentChurn(BenchmarkResult& result) {
+	//Za svaki proces ime deljenog segmenta na svakom mestu, prazno ako je mesto slobodno. Na mestima obicnih segmenata ime je "-".
+	std::vector<std::vector<std::string>> slots(this->processes.size(), std::vector<std::string>(CHURN_SLOTS));
+	unsigned long failures = 0;
+
+	for (unsigned int sample = 0; sample < this->warmup + this->samples; sample++) {
+		unsigned int index = this->random() % this->processes.size();
+		Process* process = this->processes[index];
+
+		bool shared = this->random() % 2 == 0;
+		unsigned int name = this->random() % CHURN_SHARED_NAMES;
+		unsigned int slot = shared ? CHURN_SLOTS - CHURN_SHARED_SLOTS + name % CHURN_SHARED_SLOTS : this->random() % (CHURN_SLOTS - CHURN_SHARED_SLOTS);
+		std::string sharedName = "churn" + std::to_string(name);
+
+		VirtualAddress address = (VirtualAddress)slot * PMT2_SIZE * PAGE_SIZE;
+		PageNum pages = shared ? 1 + name * SEGMENT_PAGES / CHURN_SHARED_NAMES : 1 + this->random() % PMT2_SIZE; //Deljeni segment istog imena je iste velicine
+
+		std::string& current = slots[index][slot];
+		if (shared && !current.empty() && current != sharedName) continue; //Mesto zauzima drugi deljeni segment
+
+		bool create = current.empty();
+		Status status;
+
+		unsigned long long start = now();
+		if (create) status = shared ? process->createSharedSegment(address, pages, sharedName.c_str(), READ_WRITE) : process->createSegment(address, pages, READ_WRITE);
+		else status = shared ? process->deleteSharedSegment(sharedName.c_str()) : process->deleteSegment(address);
+		unsigned long long time = now() - start;
+
+		if (status != OK && !create) {
+			result.skipped = "segment ne moze da se obrise";
+			return;
+		}
+
+		if (status != OK) ++failures; //Kreiranje ne uspeva samo ako nema mesta za tabele
+		else if (create) current = shared ? sharedName : "-";
+		else if (!shared) current.clear();
+		else { //Brisanje deljenog segmenta ga odvaja od svih procesa
+			for (std::vector<std::string>& processSlots : slots) {
+				for (std::string& processSlot : processSlots) {
+					if (processSlot == sharedName) processSlot.clear();
+				}
+			}
+		}
+
+		if (sample >= this->warmup) result.samples.push_back((double)time);
+	}
+
+	SystemStats stats = this->system->getStats();
+
+	result.metrics.push_back({ "allocationFailures", failures });
+	result.metrics.push_back({ "pmtSpaceUsed", stats.pmtSpaceUsed });
+	result.metrics.push_back({ "pmtFreeRegions", stats.pmtFreeRegions });
+	result.metrics.push_back({ "pmtLargestFreeRegion", stats.pmtLargestFreeRegion });
+}
+
+void Benchmark::threadedAccess(BenchmarkResult& result) {
+	result.unit = "access";
+
+	//Segmenti svih procesa su za cetvrtinu veci od memorije, desetina stranica procesa je segment koda ucitan pri kreiranju
+	PageNum pages = (result.frames + result.frames / 4) / this->processes.size();
+	PageNum codePages = std::max<PageNum>(pages / 10, 1);
+	PageNum dataPages = pages - codePages;
+	VirtualAddress dataStart = (VirtualAddress)codePages * PAGE_SIZE;
+
+	if (dataPages == 0) {
+		result.skipped = "manje frejmova nego procesa";
+		return;
+	}
+	if (pages * this->processes.size() > this->partition->getNumOfClusters()) {
+		result.skipped = "particija nema dovoljno klastera";
+		return;
+	}
+
+	std::vector<char> code(codePages * PAGE_SIZE, 1);
+
+	for (Process* process : this->processes) {
+		if (process->loadSegment(0, codePages, EXECUTE, code.data()) != OK || process->createSegment(dataStart, dataPages, READ_WRITE) != OK) {
+			result.skipped = "segment ne moze da se kreira";
+			return;
+		}
+	}
+
+	unsigned int threads = this->processes.size();
+	unsigned int blocks = (this->samples + threads - 1) / threads; //Uzorci se dele na niti
+	std::vector<std::vector<double>> samples(threads);
+	std::atomic<unsigned int> warmedUp(0);
+	std::atomic<bool> failed(false);
+	unsigned long long start = 0;
+
+	auto run = [&](unsigned int thread) {
+		Process* process = this->processes[thread];
+		unsigned long long state = 88172645463325252ULL + thread;
+
+		for (unsigned int block = 0; block < this->warmup + blocks && !failed; block++) {
+			if (block == this->warmup) { //Merenje pocinje kad sve niti zavrse zagrevanje
+				if (++warmedUp == threads) start = now();
+				while (warmedUp < threads && !failed) std::this_thread::yield();
+			}
+
+			unsigned long long blockStart = now();
+
+			//Instrukcija je citanje koda i pristup podacima, od tri pristupa podacima dva su upisi
+			for (unsigned int i = 0; i < ACCESS_BLOCK; i++) {
+				VirtualAddress address = (i % 2 == 0) ? xorshift(state) % dataStart : dataStart + xorshift(state) % ((VirtualAddress)dataPages * PAGE_SIZE);
+				AccessType type = (i % 2 == 0) ? EXECUTE : ((i % 3 != 0) ? WRITE : READ);
+
+				Status status = this->system->access(process->getProcessId(), address, type);
+				if (status == PAGE_FAULT && process->pageFault(address) == OK) status = this->system->access(process->getProcessId(), address, type);
+
+				if (status != OK) failed = true;
+			}
+
+			if (block >= this->warmup) samples[thread].push_back((double)(now() - blockStart) / ACCESS_BLOCK);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned int thread = 1; thread < threads; thread++) workers.emplace_back(run, thread);
+	run(0);
+	for (std::thread& worker : workers) worker.join();
+
+	double seconds = (double)(now() - start) / 1e9;
+
+	if (failed) {
+		result.skipped = "pristup ili page fault nije uspeo";
+		return;
+	}
+
+	for (std::vector<double>& threadSamples : samples) result.samples.insert(result.samples.end(), threadSamples.begin(), threadSamples.end());
+
+	SystemStats stats = this->system->getStats();
+
+	result.metrics.push_back({ "threads", threads });
+	result.metrics.push_back({ "accessesPerSecond", (double)blocks * threads * ACCESS_BLOCK / seconds });
+	result.metrics.push_back({ "faultRatio", stats.accesses ? (double)stats.faults / stats.accesses : 0 });
+}
+
+void Benchmark::writeJson(FILE* file, const std::vector<BenchmarkResult>& results) const {
+	static const char* policies[] = { "clock", "clockpro", "arc", "2q", "lruk" };
+
+	std::fprintf(file, "{\n");
+	std::fprintf(file, "  \"config\": {\"replacementPolicy\": \"%s\", \"swapBatchSize\": %lu, \"faultAroundPages\": %lu, \"swapCacheSize\": %zu, \"mapPartition\": %s, \"directIo\": %s, \"pmtPages\": %lu, \"clusters\": %lu, \"warmup\": %u, \"samples\": %u},\n",
+		policies[this->config.replacementPolicy], this->config.swapBatchSize, this->config.faultAroundPages,
+		this->config.swapCacheSize, this->config.mapPartition ? "true" : "false", (this->partitionFlags & PARTITION_DIRECT_IO) ? "true" : "false", this->pmtPages, this->partition->getNumOfClusters(), this->warmup, this->samples);
+	std::fprintf(file, "  \"results\": [");
+
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchmarkResult& result = results[i];
+
+		std::fprintf(file, "%s\n    {\"name\": \"%s\", \"frames\": %lu, \"processes\": %u, \"unit\": \"ns/%s\"", (i > 0) ? "," : "",
+			result.name.c_str(), result.frames, result.processes, result.unit);
+
+		if (!result.skipped.empty() || result.samples.empty()) {
+			std::fprintf(file, ", \"skipped\": \"%s\"}", result.skipped.empty() ? "nema uzoraka" : result.skipped.c_str());
+			continue;
+		}
+
+		std::vector<double> sorted(result.samples);
+		std::sort(sorted.begin(), sorted.end());
+
+		double sum = 0;
+		for (double sample : sorted) sum += sample;
+
+		auto percentile = [&](double p) { return sorted[std::min(sorted.size() - 1, (size_t)(p * sorted.size()))]; };
+
+		std::fprintf(file, ", \"samples\": %zu, \"mean\": %.1f, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f",
+			sorted.size(), sum / sorted.size(), percentile(0.5), percentile(0.9), percentile(0.99), sorted.back());
+
+		for (size_t j = 0; j < result.metrics.size(); j++) {
+			std::fprintf(file, "%s\"%s\": %.10g", (j == 0) ? ", \"metrics\": {" : ", ", result.metrics[j].first.c_str(), result.metrics[j].second);
+		}
+
+		std::fprintf(file, "%s}", result.metrics.empty() ? "" : "}");
+	}
+
+	std::fprintf(file, "\n  ]\n}\n");
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "vm_declarations.h"
+#include "SystemConfig.h"
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+class System;
+class Process;
+class Partition;
+
+//Rezultat jednog merenja za zadati broj frejmova i procesa. Uzorci su u nanosekundama po jedinici merenja
+//(pristup, stranica ili poziv), bez uzoraka iz zagrevanja.
+struct BenchmarkResult {
+	std::string name;
+	PageNum frames;
+	unsigned int processes;
+	const char* unit;
+	std::vector<double> samples;
+	std::string skipped; //Razlog zbog kog merenje nije izvrseno, prazan ako je izvrseno
+	std::vector<std::pair<std::string, double>> metrics; //Vrednosti merenja koje nisu uzorci vremena, npr. propusnost
+};
+
+//Merenja osnovnih operacija sistema. Svako merenje pravi novi sistem sa zadatim brojem frejmova i procesa,
+//a sve operacije izvrsava jedna nit, procesima redom. Izuzetak je threaded_access, u kome svaki proces ima svoju nit.
+class Benchmark {
+public:
+	Benchmark(Partition* partition, unsigned int partitionFlags, const SystemConfig& config, PageNum pmtPages, unsigned int warmup, unsigned int samples);
+
+	static const char* const cases[];
+
+	bool hasCase(const char* name) const;
+
+	BenchmarkResult run(const char* name, PageNum frames, unsigned int processes);
+
+	//Rezultati u JSON formatu, sa p50, p90, p99, srednjom i najvecom vrednoscu svakog merenja
+	void writeJson(FILE* file, const std::vector<BenchmarkResult>& results) const;
+
+private:
+	void createSystem(PageNum frames);
+
+	void deleteSystem();
+
+	void createProcesses(unsigned int count);
+
+	bool createSegments(BenchmarkResult& result, PageNum pages); //Segment od pages stranica u svakom procesu, ucitan pri kreiranju
+
+	void accessHit(BenchmarkResult& result);
+
+	void pageFault(BenchmarkResult& result, bool dirty);
+
+	void segment(BenchmarkResult& result, const char* operation);
+
+	//Meri cloneProcess po stranici procesa, a zatim zauzece frejmova i pmtSpace-a pre i posle CLONE_COUNT klonova koji postoje istovremeno
+	void cloneProcess(BenchmarkResult& result);
+
+	//Klon upisuje u sve svoje stranice, meri se page fault koji kopira stranicu deljenu sa roditeljem
+	void cloneWrite(BenchmarkResult& result);
+
+	void sharedSegmentAttach(BenchmarkResult& result);
+
+	void swapPage(BenchmarkResult& result);
+
+	//Alokator klastera particije se puni do tri cetvrtine nizovima od jednog klastera do velike stranice, pa se nizovi
+	//naizmenicno oslobadjaju i alociraju. Meri se allocateRun ili freeRun, a rezultat sadrzi fragmentaciju na kraju.
+	void clusterAllocator(BenchmarkResult& result, bool measureFree);
+
+	//Procesi naizmenicno kreiraju i brisu segmente i deljene segmente slucajnih velicina, a meri se svaki poziv.
+	//Rezultat sadrzi broj neuspelih kreiranja zbog nedostatka mesta za tabele i fragmentaciju pmtSpace-a na kraju.
+	void segmentChurn(BenchmarkResult& result);
+
+	//Kao ProcessTest::run, svaka nit pristupa slucajnim adresama segmenta koda i segmenta podataka svog procesa i obradjuje page fault-ove
+	void threadedAccess(BenchmarkResult& result);
+
+	//Stranice svih procesa se pristupaju redom, a page fault-ovi se izvrsavaju i mere dok se ne skupi dovoljno uzoraka
+	void faultLoop(BenchmarkResult& result, PageNum pagesPerProcess, AccessType type, bool measure);
+
+	unsigned long long random(); //xorshift, isti niz adresa pri svakom pokretanju
+
+	Partition* partition;
+	unsigned int partitionFlags; //Flegovi sa kojima je particija otvorena, upisuju se u rezultate
+	SystemConfig config;
+	PageNum pmtPages;
+	unsigned int warmup;
+	unsigned int samples;
+
+	System* system;
+	char* vmSpace;
+	char* pmtSpace;
+	std::vector<Process*> processes;
+
+	unsigned long long seed;
+};
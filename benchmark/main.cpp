@@ -0,0 +1,126 @@
+//Merenje osnovnih operacija sistema za vise velicina memorije i brojeva procesa, rezultati su u JSON formatu:
+//	g++ -std=c++14 -O2 -Ih -Ipart -Ibenchmark benchmark/*.cpp src/*.cpp part/part.cpp -pthread -o vmBenchmark
+//	vmBenchmark [-p p1.ini] [-frames 1000,4000,7000] [-processes 1,4,16] [-warmup 100] [-samples 2000]
+//	            [-cases access_hit,swap_page] [-policy clock] [-swapcache KB] [-pmt 4000] [-mmap] [-direct]
+//	            [-o rezultati.json]
+//U merenju threaded_access svaki proces ima svoju nit, pa je lista -processes lista brojeva niti. -mmap mapira fajl particije
+//u memoriju (SystemConfig::mapPartition), a -direct otvara particiju sa PARTITION_DIRECT_IO.
+#include "Benchmark.h"
+#include "part.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static std::vector<unsigned long> parseList(const char* list) {
+	std::vector<unsigned long> values;
+
+	for (const char* p = list; *p != '\0'; ) {
+		char* end;
+		unsigned long value = std::strtoul(p, &end, 10);
+		if (end == p) break;
+
+		values.push_back(value);
+		p = (*end == ',') ? end + 1 : end;
+	}
+	return values;
+}
+
+static bool setPolicy(const char* name, SystemConfig& config) {
+	static const struct { const char* name; ReplacementPolicyType type; } policies[] = {
+		{ "clock", CLOCK }, { "clockpro", CLOCK_PRO }, { "arc", ARC }, { "2q", TWO_QUEUE }, { "lruk", LRU_K }
+	};
+
+	for (const auto& policy : policies) {
+		if (std::strcmp(policy.name, name) == 0) {
+			config.replacementPolicy = policy.type;
+			return true;
+		}
+	}
+	return false;
+}
+
+int main(int argc, char** argv) {
+	const char* partitionFile = "p1.ini";
+	const char* outputFile = nullptr;
+	std::vector<unsigned long> frames = { 1000, 4000, 7000 };
+	std::vector<unsigned long> processes = { 1, 4, 16 };
+	std::vector<std::string> cases;
+	unsigned int warmup = 100;
+	unsigned int samples = 2000;
+	PageNum pmtPages = 4000;
+	unsigned int partitionFlags = 0;
+	SystemConfig config;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+
+		if (std::strcmp(argv[i], "-mmap") == 0) config.mapPartition = true;
+		else if (std::strcmp(argv[i], "-direct") == 0) partitionFlags |= PARTITION_DIRECT_IO;
+		else if (hasValue && std::strcmp(argv[i], "-p") == 0) partitionFile = argv[++i];
+		else if (hasValue && std::strcmp(argv[i], "-o") == 0) outputFile = argv[++i];
+		else if (hasValue && std::strcmp(argv[i], "-frames") == 0) frames = parseList(argv[++i]);
+		else if (hasValue && std::strcmp(argv[i], "-processes") == 0) processes = parseList(argv[++i]);
+		else if (hasValue && std::strcmp(argv[i], "-warmup") == 0) warmup = std::atoi(argv[++i]);
+		else if (hasValue && std::strcmp(argv[i], "-samples") == 0) samples = std::atoi(argv[++i]);
+		else if (hasValue && std::strcmp(argv[i], "-pmt") == 0) pmtPages = std::atoi(argv[++i]);
+		else if (hasValue && std::strcmp(argv[i], "-swapcache") == 0) config.swapCacheSize = (size_t)std::atol(argv[++i]) * 1024;
+		else if (hasValue && std::strcmp(argv[i], "-policy") == 0 && setPolicy(argv[i + 1], config)) i++;
+		else if (hasValue && std::strcmp(argv[i], "-cases") == 0) {
+			std::string list = argv[++i];
+			for (size_t start = 0, end; start <= list.size(); start = end + 1) {
+				end = list.find(',', start);
+				if (end == std::string::npos) end = list.size();
+				cases.push_back(list.substr(start, end - start));
+			}
+		}
+		else {
+			std::fprintf(stderr, "GRESKA: nepoznat argument %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	if (samples == 0) {
+		std::fprintf(stderr, "GRESKA: broj uzoraka mora biti veci od 0\n");
+		return 2;
+	}
+
+	Partition partition(partitionFile, partitionFlags);
+	Benchmark benchmark(&partition, partitionFlags, config, pmtPages, warmup, samples);
+
+	if (cases.empty()) {
+		for (int i = 0; Benchmark::cases[i] != nullptr; i++) cases.push_back(Benchmark::cases[i]);
+	}
+
+	for (const std::string& name : cases) {
+		if (!benchmark.hasCase(name.c_str())) {
+			std::fprintf(stderr, "GRESKA: nepoznato merenje %s\n", name.c_str());
+			return 2;
+		}
+	}
+
+	std::vector<BenchmarkResult> results;
+
+	for (const std::string& name : cases) {
+		for (unsigned long frameCount : frames) {
+			for (unsigned long processCount : processes) {
+				if (frameCount == 0 || processCount == 0) continue;
+
+				std::fprintf(stderr, "%s, %lu frejmova, %lu procesa\n", name.c_str(), frameCount, processCount);
+				results.push_back(benchmark.run(name.c_str(), frameCount, (unsigned int)processCount));
+			}
+		}
+	}
+
+	FILE* file = (outputFile != nullptr) ? std::fopen(outputFile, "w") : stdout;
+	if (file == nullptr) {
+		std::fprintf(stderr, "GRESKA: fajl %s ne moze da se otvori\n", outputFile);
+		return 1;
+	}
+
+	benchmark.writeJson(file, results);
+
+	if (file != stdout) std::fclose(file);
+	return 0;
+}
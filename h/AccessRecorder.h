@@ -0,0 +1,184 @@
+#pragma once
+#include "vm_declarations.h"
+#include "ConstantsAndMasks.h"
+#include "AccessRequest.h"
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//Snimak poziva sistema (System::startRecording) koji tools/AccessReplay.cpp ponovo izvrsava nad sistemom proizvoljne konfiguracije:
+//	g++ -std=c++14 -O2 -Ih -Ipart tools/AccessReplay.cpp src/*.cpp part/part.cpp -pthread -o accessReplay
+//Svaka nit kodira svoje dogadjaje u svoj bafer i upisuje ga u fajl kad se napuni, a redosled dogadjaja razlicitih niti
+//odredjuje zajednicki redni broj. Dogadjaj je kodiran kao bajt sa vrstom dogadjaja, razlika rednog broja od prethodnog
+//dogadjaja niti, ID procesa ako se razlikuje od prethodnog i podaci dogadjaja. Adrese pristupa se kodiraju kao razlika od
+//prethodne adrese niti, a svi brojevi kao varint, po 7 bita u bajtu.
+
+enum class AccessTraceEvent : unsigned char {
+	ACCESS, //access je vratio OK
+	ACCESS_PAGE_FAULT,
+	ACCESS_TRAP,
+	ACCESS_BATCH,
+	PAGE_FAULT,
+	PERIODIC_JOB,
+	CREATE_PROCESS,
+	DELETE_PROCESS,
+	CLONE_PROCESS,
+	CREATE_SEGMENT,
+	LOAD_SEGMENT, //Sadrzaj segmenta se ne snima
+	DELETE_SEGMENT,
+	CREATE_SHARED_SEGMENT,
+	DISCONNECT_SHARED_SEGMENT,
+	DELETE_SHARED_SEGMENT,
+
+	EVENT_COUNT
+};
+
+//Bajt na pocetku dogadjaja: vrsta dogadjaja, oznaka da sledi ID procesa i tip pristupa, prava pristupa segmenta ili status
+#define ACCESS_TRACE_EVENT_MASK 0x0F
+#define ACCESS_TRACE_PID 0x10
+#define ACCESS_TRACE_VALUE_SHIFT 5
+#define ACCESS_TRACE_VALUE_MASK 0x3
+
+#define ACCESS_TRACE_FILE_MAGIC "VMACCTR"
+
+//Zaglavlje fajla, brojevi dogadjaja i blokova se upisuju pri zavrsetku snimanja
+struct AccessTraceHeader {
+	char magic[8];
+	unsigned int chunkSize;
+	unsigned int threads;
+	unsigned long long events;
+	unsigned long long chunks;
+};
+
+//Zaglavlje bloka koji je nit upisala u fajl. Blokovi jedne niti su u fajlu svojim redom, a svaki blok se dekodira nezavisno.
+struct AccessTraceChunk {
+	unsigned int thread;
+	unsigned int bytes;
+	unsigned int events;
+};
+
+//Bafer niti koja snima dogadjaje. Stanje za racunanje razlika se ponistava na pocetku svakog bloka.
+struct AccessTraceBuffer {
+	unsigned char data[ACCESS_TRACE_CHUNK_SIZE];
+	unsigned int bytes;
+	unsigned int events;
+	unsigned long long lastSequence;
+	VirtualAddress lastAddress;
+	ProcessId lastPid;
+	bool pidValid;
+	unsigned int thread;
+	AccessTraceBuffer* next;
+};
+
+//Dekodirani dogadjaj. Polja koja dogadjaj ne koristi su 0.
+struct AccessTraceRecord {
+	unsigned long long sequence;
+	AccessTraceEvent event;
+	unsigned int thread; //Redni broj niti u snimku, od 1
+	ProcessId pid; //ID procesa pri snimanju, za CLONE_PROCESS proces koji se kopira
+	ProcessId newPid; //ID klona, 0 ako kopiranje nije uspelo
+	VirtualAddress address;
+	PageNum size;
+	AccessType type; //Tip pristupa ili prava pristupa segmenta
+	Status status;
+	bool populate;
+	bool superpages;
+	std::vector<AccessRequest> requests; //Adrese ACCESS_BATCH dogadjaja
+	std::string name; //Ime deljenog segmenta
+};
+
+class AccessRecorder {
+public:
+	AccessRecorder();
+
+	~AccessRecorder(); //Zatvara fajl ako nije zatvoren
+
+	bool open(const char* fileName);
+
+	//Upisuje bafere svih niti i zaglavlje. Poziva se kad nijedna nit ne koristi sistem.
+	bool close();
+
+	void recordAccess(ProcessId pid, VirtualAddress address, AccessType type, Status status);
+
+	void recordAccessBatch(ProcessId pid, const AccessRequest* requests, PageNum count, Status status);
+
+	void recordPageFault(ProcessId pid, VirtualAddress address, Status status);
+
+	void recordPeriodicJob();
+
+	void recordProcess(AccessTraceEvent event, ProcessId pid); //CREATE_PROCESS i DELETE_PROCESS
+
+	void recordClone(ProcessId pid, ProcessId newPid);
+
+	void recordSegment(AccessTraceEvent event, ProcessId pid, VirtualAddress address, PageNum size, AccessType flags, Status status, bool populate = false, bool superpages = false);
+
+	void recordDeleteSegment(ProcessId pid, VirtualAddress address, Status status);
+
+	void recordSharedSegment(AccessTraceEvent event, ProcessId pid, const char* name, Status status, VirtualAddress address = 0, PageNum size = 0, AccessType flags = READ);
+
+private:
+	//Bafer niti sa mestom za dogadjaj od size bajtova, upisuje bajt vrste dogadjaja, redni broj i ID procesa
+	AccessTraceBuffer* begin(AccessTraceEvent event, ProcessId pid, unsigned int value, unsigned int size);
+
+	AccessTraceBuffer* getBuffer();
+
+	void flush(AccessTraceBuffer* buffer);
+
+	FILE* file;
+
+	unsigned long recorderId; //Bafer koji nit pamti vazi samo za snimak sa istim rednim brojem
+
+	static std::atomic<unsigned long> nextRecorderId;
+
+	std::atomic<unsigned long long> sequence; //Redni broj sledeceg dogadjaja
+
+	AccessTraceBuffer* buffers; //Lista bafera svih niti
+	unsigned int threads;
+
+	unsigned long long events; //Dogadjaji u upisanim blokovima
+	unsigned long long chunks;
+
+	bool failed; //Neki upis u fajl nije uspeo
+
+	std::mutex fileMutex; //Stiti fajl, listu bafera i brojace upisanih blokova
+};
+
+//Cita snimak redom rednih brojeva dogadjaja, spajanjem blokova svih niti. Iz fajla se istovremeno drzi po jedan blok svake niti.
+class AccessTraceReader {
+public:
+	AccessTraceReader();
+
+	~AccessTraceReader();
+
+	bool open(const char* fileName);
+
+	bool next(AccessTraceRecord& record); //false na kraju snimka ili ako je fajl neispravan, tada je isCorrupt true
+
+	bool isCorrupt() const;
+
+	const AccessTraceHeader& getHeader() const;
+
+private:
+	struct Cursor {
+		std::vector<long> chunks; //Pozicije blokova niti u fajlu
+		size_t nextChunk;
+		std::vector<unsigned char> data;
+		unsigned int position;
+		unsigned long long lastSequence;
+		VirtualAddress lastAddress;
+		ProcessId lastPid;
+		bool hasRecord;
+		AccessTraceRecord record; //Sledeci dogadjaj niti
+	};
+
+	bool advance(Cursor& cursor); //Dekodira sledeci dogadjaj niti u cursor.record
+
+	bool decode(Cursor& cursor, AccessTraceRecord& record);
+
+	FILE* file;
+	AccessTraceHeader header;
+	std::vector<Cursor> cursors;
+	bool corrupt;
+};
@@ -0,0 +1,13 @@
+#pragma once
+#include "vm_declarations.h"
+
+//Jedna adresa u pristupu vise adresa odjednom, npr. operandima jedne instrukcije
+struct AccessRequest {
+	VirtualAddress address;
+	AccessType type;
+};
+
+struct AccessResult {
+	Status status; //OK ili TRAP, stranica koja nije bila u memoriji je ucitana pre vracanja rezultata
+	PhysicalAddress physicalAddress; //Fizicka adresa bajta, nullptr ako pristup nije dozvoljen
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include "ReplacementPolicy.h"
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+//ARC (Megiddo, Modha 2003) u varijanti sa satom (CAR, Bansal, Modha 2004). T1 sadrzi stranice
+//referencirane jednom, T2 stranice referencirane vise puta, a B1 i B2 kljuceve stranica izbacenih
+//iz T1 i T2. Ciljana velicina T1 (p) se prilagodjava promasajima u B1 i B2. Pogodak samo postavlja
+//reference bit, a premestanje u T2 se radi pri trazenju stranice za izbacivanje.
+class ArcPolicy : public ReplacementPolicy {
+public:
+	ArcPolicy(PageNum numberOfFrames);
+
+	~ArcPolicy();
+
+	void pageAccessed(PageNum frame) override;
+
+	void pageLoaded(PageNum frame, PageKey key) override;
+
+	PageNum selectVictim() override;
+
+	void pageEvicted(PageNum frame) override;
+
+	void frameFreed(PageNum frame) override;
+
+	bool isIdle(PageNum frame) const override;
+
+private:
+
+	enum ListType { NONE, T1, T2 };
+
+	void removeGhost(std::list<PageKey>& list, std::unordered_map<PageKey, std::list<PageKey>::iterator>& map, std::list<PageKey>::iterator key);
+
+	PageNum numberOfFrames;
+
+	std::list<PageNum> t1, t2; //Pocetak liste je pozicija kazaljke
+
+	std::list<PageKey> b1, b2; //Pocetak liste je najskorije izbacena stranica
+
+	std::unordered_map<PageKey, std::list<PageKey>::iterator> b1Map, b2Map;
+
+	std::list<PageNum>::iterator* entries; //Ulaz u T1 ili T2 za svaki frejm
+
+	ListType* list;
+
+	PageKey* keys;
+
+	std::atomic<bool>* referenced; //Postavlja se u pageAccessed bez zakljucavanja
+
+	PageNum target; //Ciljana velicina T1 (p)
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include "ReplacementPolicy.h"
+#include <atomic>
+
+//Second chance algoritam sa starenjem: periodicJob pomera reference bite u brojace starosti,
+//a izbacuje se najstarija stranica iz prozora od SWAP_SCAN_WINDOW frejmova ispred kazaljke.
+class ClockPolicy : public ReplacementPolicy {
+public:
+	ClockPolicy(PageNum numberOfFrames);
+
+	~ClockPolicy();
+
+	void pageAccessed(PageNum frame) override;
+
+	void pageLoaded(PageNum frame, PageKey key) override;
+
+	void pagePrefetched(PageNum frame, PageKey key) override;
+
+	PageNum selectVictim() override;
+
+	void pageEvicted(PageNum frame) override;
+
+	void frameFreed(PageNum frame) override;
+
+	bool isIdle(PageNum frame) const override;
+
+	void periodicJob() override;
+
+private:
+
+	bool isReferenced(PageNum frame) const;
+
+	void resetReferenced(PageNum frame);
+
+	PageNum numberOfFrames;
+
+	std::atomic<unsigned char>* referenceBits; //Postavljaju se u pageAccessed bez zakljucavanja
+
+	unsigned char* frameAge; //Brojaci starosti frejmova, periodicJob u njih pomera reference bite
+
+	bool* loaded; //Da li se u frejmu nalazi stranica
+
+	PageNum clockHand; //Pokazivac na sledecu stranicu za zamenu
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include "ReplacementPolicy.h"
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+//CLOCK-Pro (Jiang, Chen, Zhang 2005). Stranice su vruce ili hladne, hladne stranice u memoriji i
+//stranice izbacene tokom test perioda se nalaze u istoj kruznoj listi koju obilaze tri kazaljke.
+//Stranica koja je ponovo referencirana tokom test perioda postaje vruca, pa sken pristupi ne
+//mogu da izbace stranice koje se ciklicno koriste.
+class ClockProPolicy : public ReplacementPolicy {
+public:
+	ClockProPolicy(PageNum numberOfFrames);
+
+	~ClockProPolicy();
+
+	void pageAccessed(PageNum frame) override;
+
+	void pageLoaded(PageNum frame, PageKey key) override;
+
+	PageNum selectVictim() override;
+
+	void pageEvicted(PageNum frame) override;
+
+	void frameFreed(PageNum frame) override;
+
+	bool isIdle(PageNum frame) const override;
+
+private:
+
+	struct Entry {
+		Entry(PageKey key, PageNum frame, bool hot, bool test) : key(key), frame(frame), hot(hot), test(test) {}
+		PageKey key;
+		PageNum frame; //numberOfFrames ako stranica nije u memoriji
+		bool hot;
+		bool test; //Da li je stranica u test periodu
+	};
+
+	typedef std::list<Entry>::iterator EntryIterator;
+
+	EntryIterator insertAtHead(const Entry& entry);
+
+	void remove(EntryIterator entry);
+
+	void advance(EntryIterator& hand);
+
+	void runHandHot();
+
+	void runHandTest();
+
+	PageNum numberOfFrames;
+
+	std::list<Entry> clock; //Kruzna lista, glava liste je pozicija neposredno iza kazaljke za vruce stranice
+
+	std::unordered_map<PageKey, EntryIterator> nonResident; //Izbacene stranice u test periodu
+
+	EntryIterator* entries; //Ulaz u listi za svaki frejm
+
+	bool* loaded;
+
+	std::atomic<bool>* referenced; //Postavlja se u pageAccessed bez zakljucavanja
+
+	EntryIterator handHot, handCold, handTest;
+
+	PageNum hotCount, coldCount, coldTarget; //coldTarget je ciljani broj hladnih stranica u memoriji (mc)
+};
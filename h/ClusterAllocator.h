@@ -0,0 +1,45 @@
+#pragma once
+#include "vm_declarations.h"
+#include "part.h"
+#include <cstddef>
+#include <map>
+#include <set>
+#include <utility>
+
+//Alokator klastera na particiji. Slobodni klasteri se cuvaju kao nizovi susednih klastera (ekstenti)
+//uredjeni po pocetnom klasteru, pa se pri oslobadjanju ekstent spaja sa susedima. Isti ekstenti se
+//cuvaju i uredjeni po velicini, da bi allocateRun u O(log n) nasao najmanji dovoljno veliki ekstent.
+class ClusterAllocator {
+public:
+	ClusterAllocator(ClusterNo numberOfClusters);
+
+	ClusterNo allocate(); //Vraca slobodan klaster sa najmanjim brojem, baca MemoryException ako ga nema
+
+	ClusterNo allocateRun(ClusterNo count); //Vraca prvi od count susednih slobodnih klastera, baca MemoryException ako takav niz ne postoji
+
+	void free(ClusterNo cluster);
+
+	void freeRun(ClusterNo first, ClusterNo count);
+
+	ClusterNo getFreeClusters() const;
+
+	ClusterNo getLargestRun() const;
+
+	size_t getNumberOfExtents() const; //Broj nepovezanih nizova slobodnih klastera, mera fragmentacije
+
+private:
+
+	void insertExtent(ClusterNo first, ClusterNo count);
+
+	void eraseExtent(std::map<ClusterNo, ClusterNo>::iterator extent);
+
+	ClusterNo takeFromExtent(std::map<ClusterNo, ClusterNo>::iterator extent, ClusterNo count);
+
+	ClusterNo numberOfClusters;
+
+	ClusterNo freeClusters;
+
+	std::map<ClusterNo, ClusterNo> extents; //Pocetni klaster -> broj klastera u ekstentu
+
+	std::set<std::pair<ClusterNo, ClusterNo>> extentsBySize; //(broj klastera, pocetni klaster)
+};
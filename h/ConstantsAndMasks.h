@@ -1,11 +1,29 @@
 #pragma once
 
-//#define PRINT
+//Nivoi tragova (Trace.h). Tragovi iznad nivoa TRACE_LEVEL se ne prevode, pa sa TRACE_LEVEL_NONE ne postoje u kodu.
+//Nivo se zadaje pri prevodjenju, npr. -DTRACE_LEVEL=TRACE_LEVEL_DEBUG, isti za sve fajlove.
+#define TRACE_LEVEL_NONE 0
+#define TRACE_LEVEL_ERROR 1 //Greske u pozivima metoda procesa i sistema
+#define TRACE_LEVEL_INFO 2 //Pristupi i page fault-ovi koji vracaju TRAP
+#define TRACE_LEVEL_DEBUG 3 //Svaki page fault i citanje stranice sa diska
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL TRACE_LEVEL_NONE
+#endif
+
+#define TRACE_BUFFER_SIZE 8192 //Broj dogadjaja u kruznom baferu svake niti, stepen dvojke. Stariji dogadjaji se prepisuju.
+
+#define ACCESS_TRACE_CHUNK_SIZE 65536 //Velicina bafera u kome nit kodira dogadjaje snimka pristupa pre upisa u fajl
+#define ACCESS_TRACE_MAX_BATCH 4096 //accessBatch sa vise adresa se snima kao vise uzastopnih dogadjaja
 
 #define PMT_ENTRY_MASK 0x7F
 
-#define FRAME_MASK 0x0003FFFFF
-#define FRAME_MASK_DELETE 0xFFFC00000
+#define FRAME_MASK 0x001FFFFF //Redni broj frejma u processVMSpace-u, sistem koristi najvise 2M frejmova
+#define FRAME_MASK_DELETE 0xFFE00000
+
+#define COW_MASK 0x00200000 //COW bit oznacava stranicu koju proces deli sa klonom, prvi upis u nju pravi kopiju
+#define SET_COW 0x00200000
+#define RESET_COW 0xFFDFFFFF
 
 #define PMT1_SIZE 128
 #define PMT1_OFFSET 17
@@ -13,6 +31,9 @@
 #define PMT2_SIZE 128
 #define PMT2_OFFSET 10
 
+#define SUPERPAGE_SIZE PMT2_SIZE //Velika stranica preslikava ceo ulaz tabele prvog nivoa u poravnat niz od toliko frejmova
+#define SUPERPAGE_MASK (SUPERPAGE_SIZE - 1)
+
 #define SET_V 0x01000000
 #define RESET_V 0xFEFFFFFF
 #define V_MASK 0x01000000
@@ -33,15 +54,67 @@
 #define SET_SH 0x10000000
 #define RESET_SH 0xEFFFFFFF
 
+#define F_MASK 0x20000000 //F bit oznacava da je stranica ucitana zbog page fault-a, a prvi sledeci pristup je ponovljeni pristup koji je izazvao gresku
+#define SET_F 0x20000000
+#define RESET_F 0xDFFFFFFF
+
+#define LD_MASK 0x40000000 //LD bit oznacava da je u toku ucitavanje stranice, postavlja ga proces koji obradjuje page fault
+#define SET_LD 0x40000000
+#define RESET_LD 0xBFFFFFFF
+
+#define ST_MASK 0x80000000 //ST bit oznacava prvu stranicu segmenta
+#define SET_ST 0x80000000
+#define RESET_ST 0x7FFFFFFF
+
 #define ACCESS_BITS_MASK 0x0C00000
 #define ACCESS_BITS_SHIFT 22
 
 #define PCB_HASH_SIZE 128
 
+#define DESCRIPTOR_SIZE 8
+
+#define MAX_DESCRIPTOR_CLUSTER 0xFFFFFFFF //Broj klastera u deskriptoru je 32-bitan, ostali klasteri particije se ne koriste
+#define NO_CLUSTER 0xFFFFFFFF //Stranici nije dodeljen klaster, particija se skracuje na MAX_DESCRIPTOR_CLUSTER klastera pa ovaj broj nije klaster
+
+#define CACHE_LINE_SIZE 64 //Tabele u pmtSpace-u pocinju na pocetku kes linije
+#define COW_DESCRIPTOR_SLOT_SIZE 16 //Zajednicki deskriptori stranica klonova se ne poravnavaju na kes linije, u jednu staju cetiri
+
+#define PMT_SLAB_SIZE (16 * PAGE_SIZE) //Tabele fiksne velicine se dodeljuju iz slabova ove velicine, poravnatih u odnosu na pocetak pmtSpace-a
+#define PMT_MIN_SLABS 8 //Ako u pmtSpace ne staje ovoliko slabova velicine PMT_SLAB_SIZE, slabovi se smanjuju
+#define NO_SLAB 0xFFFFFFFF
+
+#define NO_FRAME 0xFFFFFFFF //Kraj liste slobodnih frejmova
+
 #define PAGE_SIZE 1024
 
 #define REF_BITS_HOLDER_SIZE 8
 
+#define AGE_MSB 0x80 //Bit brojaca starosti u koji se upisuje reference bit pri svakom pozivu periodicJob-a
+
+#define DEFAULT_AGING_PERIOD 1000
+
+#define SWAP_SCAN_WINDOW 32 //Broj frejmova koje Clock algoritam pregleda pri trazenju najstarije stranice
+
+#define DEFAULT_LRU_K 2
+
+#define DEFAULT_SWAP_BATCH_SIZE 8
+
+#define DEFAULT_WRITEBACK_START_RATIO 10 //Procenat modifikovanih frejmova od kog periodicJob upisuje neaktivne stranice na disk
+
+#define DEFAULT_WRITEBACK_URGENT_RATIO 40 //Procenat modifikovanih frejmova od kog se upisuju sve neaktivne stranice, bez ogranicenja broja po pozivu
+
+#define DEFAULT_WRITEBACK_BATCH_SIZE 32
+
+#define DEFAULT_FAULT_AROUND_PAGES 4 //Broj susednih stranica segmenta koje page fault ucitava uz trazenu stranicu
+
+#define DEFAULT_SWAP_CACHE_SIZE 0 //Bajtovi kompresovanih stranica u kesu ispred particije, 0 iskljucuje kes
+
+#define DEFAULT_SWAP_CACHE_WRITEBACK_BATCH 32 //Najmanji broj najstarijih stranica koje kes upisuje na disk kad predje velicinu
+
+#define SWAP_CACHE_MAX_COMPRESSED_SIZE (PAGE_SIZE / 2) //Stranica koja se ne kompresuje bar na ovu velicinu se upisuje direktno na disk
+
+#define PAGE_COMPRESSOR_HASH_BITS 9 //Tabela kompresora pamti poslednju poziciju za 2^9 hes vrednosti od cetiri bajta
+
 #define ADR_WORD 10 //Duzina word polja u adresi
 #define WORD_MASK 0x3FF
 
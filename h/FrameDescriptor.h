@@ -0,0 +1,17 @@
+#pragma once
+#include "vm_declarations.h"
+
+class Descriptor;
+
+//Ulaz invertovane tabele frejmova, indeksira se brojem frejma u processVMSpace-u. Menja se samo pod evictionMutex-om.
+struct FrameDescriptor {
+
+	FrameDescriptor() : owner(nullptr), pid(0), page(0), shared(false), cleaned(false), superpage(false) {}
+
+	Descriptor* owner; //Deskriptor stranice koja se nalazi u frejmu, za deljeni segment deskriptor iz PMT-a segmenta
+	ProcessId pid; //Proces koji je stranicu poslednji ucitao
+	VirtualAddress page; //Virtuelna adresa stranice u adresnom prostoru procesa pid
+	bool shared; //Da li stranica pripada deljenom segmentu
+	bool cleaned; //Stranica je upisana na disk u pozadini dok je bila u frejmu
+	bool superpage; //Frejm je prvi frejm velike stranice, ostali frejmovi velike stranice nemaju vlasnika
+};
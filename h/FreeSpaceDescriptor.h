@@ -13,9 +13,4 @@ struct FreeSpaceDescriptor {
 	PhysicalAddress space;
 	FreeSpaceDescriptor* next;
 	size_t size;
-};
-
-struct ClustersFree {
-	ClustersFree(ClusterNo first, ClusterNo num) : first(first), num(num) {}
-	ClusterNo first, num;
 };
\ No newline at end of file
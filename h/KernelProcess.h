@@ -1,5 +1,9 @@
 #pragma once
 #include "vm_declarations.h"
+#include "part.h"
+#include <mutex>
+#include <utility>
+#include <vector>
 
 class Descriptor;
 class Process;
@@ -13,7 +17,7 @@ public:
 
 	ProcessId getProcessId() const;
 
-	Status createSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags);
+	Status createSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags, bool populate = false, bool superpages = false);
 
 	Status loadSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags, void* content);
 
@@ -23,8 +27,14 @@ public:
 
 	Status pageFault(VirtualAddress address);
 
+	//Ucitava stranice vise adresa redom po klasterima na kojima se nalaze, svaku stranicu jednom. Uspeh se proverava
+	//ponovnim pristupom.
+	void pageFaults(const std::vector<VirtualAddress>& addresses);
+
 	PhysicalAddress getPhysicalAddress(VirtualAddress address);
 
+	void countPages(PageNum& resident, PageNum& swapped); //Broj stranica u memoriji i izbacenih na disk, poziva se pod pmtMutex-om
+
 	Process* clone(ProcessId pid);
 
 	Status createSharedSegment(VirtualAddress startAddress, PageNum segmentSize, const char* name, AccessType flags);
@@ -41,7 +51,28 @@ private:
 
 	bool checkAllocated(VirtualAddress startAddress);
 
-	bool updatePMT(VirtualAddress page, PhysicalAddress frame, PageNum ordinal, AccessType flags, bool setD = false, bool setSh = false, Descriptor* sharedDesc = nullptr);
+	bool updatePMT(VirtualAddress page, PhysicalAddress frame, PageNum ordinal, AccessType flags, bool setD = false, bool setSh = false, Descriptor* sharedDesc = nullptr, bool setCow = false);
+
+	Status copyOnWrite(VirtualAddress address, Descriptor* desc); //Prvi upis u stranicu koja se deli sa klonom, poziva se iz pageFault-a
+
+	//Zauzima susedne izbacene stranice segmenta koje page fault ucitava istim citanjem i slobodne frejmove za njih,
+	//poziva se pod evictionMutex-om. Vraca broj zauzetih stranica ispred trazene.
+	PageNum claimFaultAround(VirtualAddress page, ClusterNo cluster, std::vector<std::pair<VirtualAddress, PhysicalAddress>>& around);
+
+	Descriptor* getDescriptor(VirtualAddress page); //Deskriptor stranice iz PMT-a procesa, nullptr ako tabela drugog nivoa nije alocirana
+
+	Descriptor* getSuperpage(VirtualAddress page); //Deskriptor velike stranice koja sadrzi adresu, nullptr ako ulaz tabele prvog nivoa ne preslikava veliku stranicu
+
+	bool allocatePMT1(); //Alocira tabelu prvog nivoa ako jos ne postoji
+
+	bool createSuperpage(VirtualAddress page, PageNum ordinal, AccessType flags, PhysicalAddress frame); //frame je prvi frejm poravnatog niza ili nullptr
+
+	Status superpageFault(VirtualAddress address);
+
+	//Zamenjuje veliku stranicu tabelom drugog nivoa sa SUPERPAGE_SIZE obicnih stranica na istim frejmovima i klasterima
+	bool splitSuperpage(VirtualAddress page);
+
+	Status loadSegmentToFrames(VirtualAddress startAddress, PageNum segmentSize, AccessType flags, void* content); //loadSegment kad na disku nema mesta za sadrzaj segmenta
 
 	Process* myProcess;
 
@@ -49,5 +80,9 @@ private:
 
 	ProcessId pid;
 
+	std::mutex *pmtMutex; //Stiti tabelu stranica procesa, drzi se tokom page fault-a i izmena segmenata
+
 	friend class KernelSystem;
+
+	friend class Process;
 };
\ No newline at end of file
@@ -1,13 +1,22 @@
 #pragma once
 
 #include "vm_declarations.h"
+#include "AccessRequest.h"
 #include "ConstantsAndMasks.h"
 #include "SharedSegment.h"
+#include "SystemConfig.h"
+#include "SystemStats.h"
+#include "StatCounters.h"
+#include "ReplacementPolicy.h"
 #include "part.h"
 #include <list>
 #include <mutex>
+#include <shared_mutex>
+#include <atomic>
 #include <unordered_map>
 #include <map>
+#include <utility>
+#include <vector>
 
 class Partition;
 class Descriptor;
@@ -16,13 +25,18 @@ class System;
 class PMT1;
 class KernelProcess;
 class MemoryException;
-struct ClustersFree;
+class ClusterAllocator;
+struct FrameDescriptor;
+class ReplacementPolicy;
+class SpaceAllocator;
+class AccessRecorder;
+class SwapCache;
 
 class KernelSystem {
 private:
 	KernelSystem(PhysicalAddress processVMSpace, PageNum processVMSpaceSize,
 		PhysicalAddress pmtSpace, PageNum pmtSpaceSize,
-		Partition* partition, System* mySystem);
+		Partition* partition, System* mySystem, const SystemConfig& config);
 
 	~KernelSystem();
 
@@ -34,39 +48,103 @@ private:
 
 	Status access(ProcessId pid, VirtualAddress address, AccessType type);
 
-	PhysicalAddress swapPage() throw(MemoryException);
-	
-	Descriptor* checkTables(PMT1* pmt1, unsigned int frame);
+	//Pristup vise adresa jednog procesa uz jedno trazenje procesa. Stranice koje nisu u memoriji se ucitavaju zajedno,
+	//redom po klasterima, i tek onda se proveravaju fizicke adrese, pa su sve vracene adrese vazece pri povratku.
+	Status accessBatch(ProcessId pid, const AccessRequest* requests, PageNum count, AccessResult* results);
+
+	//Prevodjenje adrese za access, za OK vraca frejm stranice. Poziva se pod deljenim zakljucavanjem mape procesa.
+	//Bez report-a se samo proveravaju flegovi, a pristup se ne prijavljuje algoritmu zamene.
+	Status translate(KernelProcess* process, VirtualAddress address, AccessType type, PageNum& frame, bool report = true);
+
+	PhysicalAddress swapPage();
+
+	void writeBack(); //Upis modifikovanih stranica koje se ne koriste na disk, poziva se iz periodicJob-a bez evictionMutex-a
+
+	bool writeClusterRuns(std::vector<std::pair<ClusterNo, const char*>>& pages); //Sortira stranice po klasterima i upisuje ih u kes kompresovanih stranica ili na disk
+
+	bool writePartitionRuns(const std::vector<std::pair<ClusterNo, const char*>>& pages); //Upisuje stranice sortirane po klasterima na disk, jednim pozivom za svaki niz susednih klastera
+
+	bool readClusters(ClusterNo first, ClusterNo count, char* const* buffers); //Cita susedne klastere iz kesa kompresovanih stranica ili sa diska i broji klastere procitane sa diska
+
+	//Metode za odrzavanje invertovane tabele frejmova
+
+	PageNum getFrameIndex(PhysicalAddress frame) const;
+
+	PhysicalAddress getFrameAddress(PageNum frame) const;
+
+	//Deskriptor stranice deljenog segmenta cuva redni broj deskriptora segmenta u pmtSpace-u umesto pokazivaca
+
+	Descriptor* getSharedDescriptor(const Descriptor* desc) const;
+
+	unsigned int getSharedIndex(const Descriptor* sharedDesc) const;
+
+	//mapFrame i unmapFrame se pozivaju pod evictionMutex-om. Velika stranica se prijavljuje samo svojim prvim frejmom,
+	//a unmapFrame tada ponistava prevodjenja na sve njene frejmove.
+
+	void mapFrame(PhysicalAddress frame, Descriptor* owner, ProcessId pid, VirtualAddress page, bool shared = false, bool prefetched = false, bool superpage = false);
+
+	void unmapFrame(PhysicalAddress frame);
+
+	void setFrameOwner(PageNum frame, Descriptor* owner, ProcessId pid, VirtualAddress page, bool shared); //Menja vlasnika frejma bez obavestavanja algoritma zamene
+
+	PageKey getPageKey(const FrameDescriptor& frameDesc) const;
+
+	SystemStats getStats();
+
+	//Brojaci niti koja poziva metodu. Blok brojaca se pravi pri prvom pozivu iz niti i ostaje do brisanja sistema.
+	StatCounters* getCounters();
 
 	//Metode za upravljanje memorijom
 
-	ClusterNo getFreeCluster() throw(MemoryException);
+	ClusterNo getFreeCluster();
+
+	ClusterNo getFreeClusterRun(ClusterNo count);
 
 	void setClusterFree(ClusterNo cluster);
 
+	//Dodeljuje klaster stranici u frejmu koja se prvi put upisuje na disk, poziva se pod evictionMutex-om. Stranicama segmenta iz
+	//iste tabele drugog nivoa koje nemaju klaster dodeljuje se ceo niz susednih klastera, redom kao u segmentu.
+	void reserveClusters(PageNum frame);
+
 	PhysicalAddress allocatePMT(PMTType type);
 
 	void deallocatePMT(PhysicalAddress adr, PMTType type);
 
 	void deallocatePage(PhysicalAddress page);
 
-	PhysicalAddress allocatePage() throw(MemoryException);
+	PhysicalAddress allocatePage();
+
+	PhysicalAddress allocateFreePage();
+
+	PhysicalAddress allocateAlignedRun(PageNum count);
+
+	void deallocatePages(PhysicalAddress first, PageNum count);
 
 	Process* cloneProcess(ProcessId pid);
 
 	void copyContent(const char* src, char* dst);
 
+	void clearContent(char* dst); //Stranica koja nikad nije upisana na disk se ucitava kao stranica ispunjena nulama
+
 	void initSegment(VirtualAddress startAddress, KernelProcess* newKP, KernelProcess* oldKP, PageNum segmentSize, ProcessId pid, AccessType flags, bool shared);
 
+	void readPage(Descriptor* desc, char* buffer); //Kopira sadrzaj stranice iz memorije ili sa diska, stranica ne moze biti izbacena tokom kopiranja
+
+	//Metode za stranice koje proces deli sa klonovima do prvog upisa
+
+	Descriptor* shareCowPage(Descriptor* desc); //Vraca deskriptor zajednicke stranice sa uvecanim brojem referenci, poziva se pod pmtMutex-om procesa
+
+	void releaseCowPage(Descriptor* cowDesc); //Smanjuje broj referenci i oslobadja stranicu posle poslednje, poziva se pod evictionMutex-om
+
 	System* mySystem;
 
-	unsigned char* referenceBits;
+	FrameDescriptor* frameTable; //Invertovana tabela frejmova, za svaki frejm cuva deskriptor stranice koja ga koristi
 
 	std::unordered_map<ProcessId, Process*> processMap;
 	
 	std::map<std::string, SharedSegment*> sharedSegments;
 
-	std::list<ClustersFree> freeClusters;
+	ClusterAllocator* clusterAllocator; //Evidencija slobodnih klastera na particiji
 
 	PhysicalAddress processVMSpace;
 	PageNum processVMSpaceSize;
@@ -77,7 +155,35 @@ private:
 	Partition* partition;
 	ClusterNo numberOfClusters;
 
-	PageNum clockHand; //Pokazivac na sledecu stranicu za zamenu (Second chance algoritam)
+	SystemConfig config;
+
+	ReplacementPolicy* replacementPolicy; //Algoritam zamene stranica izabran pri kreiranju sistema
+
+	PageNum writebackHand; //Frejm od kog sledeci poziv writeBack-a nastavlja pretragu
+
+	bool writebackInProgress; //writeBack upisuje stranice na disk bez evictionMutex-a, menja se pod evictionMutex-om
+
+	std::vector<ClusterNo> writebackClusters; //Sortirani klasteri na koje writeBack upisuje, stiti ih clusterMutex
+
+	std::vector<ClusterNo> deferredClusterFrees; //Klasteri obrisanih stranica koji se oslobadjaju posle upisa, stiti ih clusterMutex
+
+	WritebackStats writebackStats;
+
+	std::atomic<bool>* prefetchedFrames; //Frejmovi sa stranicama ucitanim unapred kojima jos nije pristupljeno
+
+	PrefetchStats prefetchStats; //Broj ucitanih unapred i neiskoriscenih stranica menja se pod evictionMutex-om
+
+	std::atomic<unsigned long> prefetchHits; //Prvi pristup stranici ucitanoj unapred broji access bez zakljucavanja
+
+	StatCounters* counters; //Lista blokova brojaca svih niti koje su koristile sistem
+
+	unsigned long systemId; //Blok brojaca koji nit pamti vazi samo za sistem sa istim rednim brojem
+
+	static unsigned long nextSystemId;
+
+	AccessRecorder* recorder; //Snimak poziva sistema, nullptr kad se ne snima
+
+	SwapCache* swapCache; //Kes kompresovanih stranica ispred particije, nullptr ako je config.swapCacheSize 0
 
 	static ProcessId nextPid; //Promenljiva koja sluzi da se pri kreiranju procesa procesu dodeli jedinstveni ID
 
@@ -89,9 +195,25 @@ private:
 
 	friend class SpaceAllocator;
 
+	friend class SwapCache;
+
+	friend class Benchmark; //Meri swapPage bez page fault-a, benchmark/Benchmark.cpp
+
 	static KernelSystem* kernelSystem;
 
 	SpaceAllocator* spaceAllocator;
 
-	std::mutex *globalMutex;
+	//Redosled zakljucavanja: sharedSegmentMutex, processMapMutex, pmtMutex procesa, evictionMutex,
+	//pa memoryMutex i pmtSpaceMutex alokatora, clusterMutex i mutex kesa kompresovanih stranica.
+	//Pogodak u access-u uzima samo deljeno zakljucavanje mape procesa.
+
+	std::shared_timed_mutex *processMapMutex; //Stiti mapu procesa i nextPid
+
+	std::mutex *sharedSegmentMutex; //Stiti mapu deljenih segmenata i spiskove procesa koji ih koriste
+
+	std::mutex *evictionMutex; //Stiti invertovanu tabelu frejmova, algoritam zamene i upis stranica na disk
+
+	std::mutex *clusterMutex; //Stiti alokator klastera
+
+	std::mutex *countersMutex; //Stiti listu blokova brojaca
 };
\ No newline at end of file
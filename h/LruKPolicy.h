@@ -0,0 +1,54 @@
+#pragma once
+#include "ReplacementPolicy.h"
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+//LRU-K (O'Neil, O'Neil, Weikum 1993). Za svaki frejm se pamti vreme poslednjih K referenci i izbacuje
+//se stranica cija je K-ta poslednja referenca najstarija, a stranica sa manje od K referenci pre svih
+//ostalih. Istorija izbacenih stranica se cuva za onoliko stranica koliko ima frejmova.
+class LruKPolicy : public ReplacementPolicy {
+public:
+	LruKPolicy(PageNum numberOfFrames, unsigned int k);
+
+	~LruKPolicy();
+
+	void pageAccessed(PageNum frame) override;
+
+	void pageLoaded(PageNum frame, PageKey key) override;
+
+	void pagePrefetched(PageNum frame, PageKey key) override;
+
+	PageNum selectVictim() override;
+
+	void pageEvicted(PageNum frame) override;
+
+	void frameFreed(PageNum frame) override;
+
+	bool isIdle(PageNum frame) const override;
+
+private:
+
+	typedef unsigned long long Timestamp;
+
+	struct History {
+		std::list<PageKey>::iterator order;
+		Timestamp* times;
+	};
+
+	PageNum numberOfFrames;
+
+	unsigned int k;
+
+	std::atomic<Timestamp> currentTime; //Logicko vreme, uvecava se pri svakoj referenci
+
+	std::atomic<Timestamp>* history; //K vremena referenci po frejmu, najskorije prvo, 0 ako referenca ne postoji. Menja se u pageAccessed bez zakljucavanja.
+
+	PageKey* keys;
+
+	bool* loaded;
+
+	std::unordered_map<PageKey, History> retained; //Istorija izbacenih stranica
+
+	std::list<PageKey> retainedOrder; //Pocetak liste je najstarija sacuvana istorija
+};
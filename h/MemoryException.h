@@ -1,5 +1,6 @@
 #pragma once
 #include <exception>
+#include <ostream>
 #include <string>
 
 class MemoryException : std::exception {
@@ -2,32 +2,46 @@
 #include "vm_declarations.h"
 #include "ConstantsAndMasks.h"
 #include "part.h"
+#include <atomic>
 
 
+//Deskriptor zauzima 8 bajtova. U frameAndFlags je redni broj frejma u processVMSpace-u, a ne adresa frejma,
+//pa prevodjenje ne zavisi od toga gde se na racunaru nalazi memorija koju koristi sistem.
 class Descriptor {
 public:
 	union {
-		ClusterNo disk;
-		Descriptor* sharedDesc;
+		unsigned int disk; //Klaster na particiji dodeljen stranici ili NO_CLUSTER. Sadrzaj je na klasteru samo ako je postavljen S bit
+		unsigned int sharedIndex; //Za stranicu deljenog segmenta redni broj deskriptora segmenta u pmtSpace-u
 	};
-	//ClusterNo disk;
-	unsigned short ordinal;
-	unsigned int frameAndFlags;
+	std::atomic<unsigned int> frameAndFlags; //Pogodak u access-u menja flegove bez zakljucavanja, pa su sve izmene atomicne
 };
 
-class PMT2 {
+static_assert(sizeof(Descriptor) == DESCRIPTOR_SIZE, "Descriptor mora da zauzima 8 bajtova");
+
+//Stranica koju dele proces i njegovi klonovi. Deskriptori stranice u PMT-ovima procesa imaju postavljene SH i COW bite
+//i pokazuju na desc, koji cuva frejm i klaster stranice kao deskriptor deljenog segmenta.
+class CowDescriptor {
+public:
+	Descriptor desc;
+	unsigned int refCount; //Broj deskriptora procesa koji pokazuju na stranicu, menja se pod evictionMutex-om
+};
+
+class alignas(CACHE_LINE_SIZE) PMT2 {
 public:
-	char entriesUsed;
 	Descriptor entry[PMT2_SIZE];
 };
 
+//Ulaz tabele prvog nivoa pokazuje na tabelu drugog nivoa ili preslikava veliku stranicu, ako je postavljen L bit
+//u deskriptoru superpage. Velika stranica je u memoriji cela ili je nema, pa joj je dovoljan jedan deskriptor.
 class PMT1 {
 public:
-	char entriesUsed;
+	unsigned char entriesUsed; //Broj alociranih tabela drugog nivoa i velikih stranica
+	unsigned char level2EntriesUsed[PMT1_SIZE]; //Broj zauzetih ulaza u svakoj tabeli drugog nivoa, cuva se ovde da PMT2 bude tacno jedna stranica
 	PMT2* level2entry[PMT1_SIZE];
+	Descriptor superpage[PMT1_SIZE]; //Frejm je prvi od SUPERPAGE_SIZE frejmova, a klaster prvi od isto toliko susednih klastera
 };
 
 class SharedSegmentPMT {
 public:
 	Descriptor* entry;
-};
\ No newline at end of file
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include "vm_declarations.h"
+#include "ConstantsAndMasks.h"
+#include <cstddef>
+
+//Brza LZ77 kompresija jedne stranice, u formatu slicnom LZ4 bloku. Niz sekvenci, svaka je bajt sa duzinom
+//literala (gornja 4 bita) i duzinom poklapanja umanjenom za 4 (donja 4 bita), nastavak duzine literala,
+//literali, rastojanje poklapanja u 2 bajta i nastavak duzine poklapanja. Duzina 15 se nastavlja bajtovima
+//koji se sabiraju dok je bajt 255. Poslednja sekvenca ima samo literale.
+class PageCompressor {
+public:
+	//Kompresuje stranicu u output i vraca broj upisanih bajtova, ili 0 ako kompresovana stranica ne staje u limit bajtova
+	static size_t compress(const char* page, char* output, size_t limit);
+
+	//Vraca false ako input nije ispravno kompresovana stranica, i ako je skracen za bilo koji broj bajtova
+	static bool decompress(const char* input, size_t size, char* page);
+};
@@ -13,7 +13,9 @@ public:
 	
 	ProcessId getProcessId() const;
 	
-	Status createSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags);
+	//Stranice segmenta dobijaju frejm ispunjen nulama pri prvom pristupu, a sa populate = true odmah pri kreiranju.
+	//Sa superpages = true se delovi segmenta koji pokrivaju ceo ulaz tabele prvog nivoa preslikavaju kao velike stranice.
+	Status createSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags, bool populate = false, bool superpages = false);
 	
 	Status loadSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags, void* content);
 	
@@ -0,0 +1,42 @@
+#pragma once
+#include "vm_declarations.h"
+#include "SystemConfig.h"
+
+typedef unsigned long long PageKey; //Kljuc stranice, jedinstven za stranicu procesa ili deljenog segmenta i dok stranica nije u memoriji
+
+//Interfejs algoritma zamene stranica. Frejmovi se identifikuju rednim brojem u processVMSpace-u.
+//Algoritam prati samo frejmove koji su mu prijavljeni metodom pageLoaded. Sve metode se pozivaju
+//pod evictionMutex-om sistema, osim pageAccessed koji se poziva iz access-a bez zakljucavanja i
+//mora biti bezbedan za istovremene pozive iz vise niti.
+class ReplacementPolicy {
+public:
+
+	virtual ~ReplacementPolicy() {}
+
+	//Pristup stranici koja je u memoriji (pogodak)
+	virtual void pageAccessed(PageNum frame) = 0;
+
+	//Stranica sa kljucem key je ucitana u frejm frame
+	virtual void pageLoaded(PageNum frame, PageKey key) = 0;
+
+	//Stranica je ucitana unapred uz stranicu koja je izazvala page fault i jos joj nije pristupljeno. Algoritmi
+	//kod kojih ucitavanje ne postavlja referencu ne moraju da redefinisu ovu metodu.
+	virtual void pagePrefetched(PageNum frame, PageKey key) { this->pageLoaded(frame, key); }
+
+	//Vraca frejm ciju stranicu treba izbaciti, ili numberOfFrames ako nema ni jednog prijavljenog frejma
+	virtual PageNum selectVictim() = 0;
+
+	//Stranica izabrana sa selectVictim je izbacena iz frejma
+	virtual void pageEvicted(PageNum frame) = 0;
+
+	//Stranica je obrisana, frejm se oslobadja bez izbacivanja
+	virtual void frameFreed(PageNum frame) = 0;
+
+	//Da li stranica u frejmu nije skoro referencirana, takve modifikovane stranice se upisuju na disk u pozadini
+	virtual bool isIdle(PageNum frame) const = 0;
+
+	//Poziva se iz periodicJob-a sistema
+	virtual void periodicJob() {}
+
+	static ReplacementPolicy* create(const SystemConfig& config, PageNum numberOfFrames);
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include <list>
+#include <string>
 #include <unordered_map>
 #include "vm_declarations.h"
 #include "PMT.h"
@@ -0,0 +1,14 @@
+#pragma once
+#include "vm_declarations.h"
+#include "ConstantsAndMasks.h"
+
+//Deo pmtSpace-a velicine slaba alokatora (PMT_SLAB_SIZE ili manje) iz kog se dodeljuju tabele jedne velicine. Slobodne tabele slaba su ulancane
+//kroz sopstvenu memoriju, a slabovi sa slobodnim tabelama iste velicine su ulancani preko rednih brojeva slabova.
+struct Slab {
+
+	Slab() : freeList(nullptr), used(0), next(NO_SLAB), prev(NO_SLAB) {}
+
+	void* freeList; //Prva slobodna tabela, u njenih prvih sizeof(void*) bajtova je upisana adresa sledece
+	PageNum used; //Broj dodeljenih tabela
+	PageNum next, prev; //Susedni slabovi u listi slabova sa slobodnim tabelama, NO_SLAB na kraju liste
+};
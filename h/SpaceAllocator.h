@@ -1,8 +1,10 @@
 #pragma once
 
 #include "PMT.h"
+#include "Slab.h"
 #include <list>
 #include <mutex>
+#include <vector>
 #include "vm_declarations.h"
 #include "MemoryException.h"
 
@@ -22,18 +24,73 @@ public:
 
 	void deallocatePage(PhysicalAddress page);
 
-	PhysicalAddress allocatePage() throw(MemoryException);
+	void deallocatePages(PhysicalAddress first, PageNum count); //Vraca niz od count susednih frejmova u listu slobodnih
+
+	PhysicalAddress allocatePage();
+
+	PhysicalAddress allocateFreePage(); //Frejm iz liste slobodnih bez izbacivanja, nullptr ako slobodnih nema
+
+	PhysicalAddress allocateContiguous(PageNum count); //Niz od count susednih slobodnih frejmova bez izbacivanja, nullptr ako takav niz ne postoji
+
+	//Niz od count slobodnih frejmova ciji je prvi redni broj deljiv sa count, bez izbacivanja. nullptr ako takav niz ne postoji.
+	PhysicalAddress allocateAlignedRun(PageNum count);
+
+	PageNum getFreeFrames() const { return freeFrames; }
 
 	static size_t pmt1Size, pmt2Size, descSize;
 	
 private:
 	friend class KernelSystem;
 
+	//Metode za frejmove se pozivaju pod memoryMutex-om
+
+	PhysicalAddress takeFreePage(); //Uzima prvi slobodan frejm
+
+	PhysicalAddress takeRun(PageNum count, PageNum alignment); //Prvi niz od count slobodnih frejmova koji pocinje frejmom deljivim sa alignment
+
+	void unlinkFreeFrame(PageNum frame); //Izbacuje frejm iz liste slobodnih
+
+	//Metode za pmtSpace se pozivaju pod pmtSpaceMutex-om
+
+	PageNum addSlab(PMTType type); //Uzima novi slab iz pmtFreeSpace-a za tabele tipa type, NO_SLAB ako nema mesta
+
+	void unlinkSlab(PMTType type, PageNum slab); //Izbacuje slab iz liste slabova sa slobodnim tabelama
+
+	bool releaseEmptySlabs(); //Vraca u pmtFreeSpace slabove bez dodeljenih tabela, false ako takvih nije bilo
+
+	PhysicalAddress takeRegion(size_t size); //Deo pmtFreeSpace-a sa kraja poslednjeg dovoljno velikog slobodnog dela
+
+	void releaseRegion(PhysicalAddress adr, size_t size); //Vraca deo u pmtFreeSpace i spaja ga sa susednim slobodnim delovima
+
+	size_t getPMTSize(PMTType type, PageNum segmentSize) const;
+
 	KernelSystem* mySystem;
 
-	FreeSpaceDescriptor *kernelHead, *pageHead, *pageTail;
+	//Slobodni frejmovi su dvostruko ulancani preko rednih brojeva u nizovima nextFree i prevFree, pa se frejm uzima
+	//sa pocetka liste i vraca na pocetak liste u konstantnom vremenu, bez alokacije. Sadrzaj slobodnih frejmova se ne
+	//menja, jer proces moze da upisuje u stranicu i posle njenog izbacivanja, preko vec dobijene fizicke adrese.
+	PageNum *nextFree, *prevFree;
+
+	bool* frameFree; //Niz susednih slobodnih frejmova se trazi po ovim oznakama
+
+	PageNum freeHead, freeFrames;
+
+	PhysicalAddress processVMSpace;
 
-	std::list<FreeSpaceDescriptor> processVMFreeSpace, pmtFreeSpace;
+	//Slobodan prostor pmtSpace-a van slabova, sortiran po adresama. Iz njega se uzimaju slabovi, od pocetka,
+	//i tabele deljenih segmenata, od kraja, pa se tabele razlicitih velicina ne mesaju. Kad ni ceo slab vise
+	//ne staje, i tabele fiksne velicine se uzimaju od kraja.
+	std::list<FreeSpaceDescriptor> pmtFreeSpace;
+
+	PhysicalAddress pmtSpace;
+
+	std::vector<Slab> slabs; //Indeksira se rednim brojem slaba u pmtSpace-u
+
+	size_t slabSize; //PMT_SLAB_SIZE, ili manje ako je pmtSpace mali
+
+	size_t pmtSpaceUsed; //Zbir velicina dodeljenih tabela, bez slobodnih tabela u slabovima
+
+	PageNum partialSlabs[COW_DESCRIPTOR + 1]; //Za svaki tip tabele fiksne velicine prvi slab sa slobodnim tabelama
 
 	PageNum kernelSpaceSize, pageSpaceSize;
 
@@ -41,5 +98,7 @@ private:
 	
 	Partition* partition;
 
-	std::mutex* memoryMutex;
+	std::mutex* memoryMutex; //Stiti listu slobodnih frejmova
+
+	std::mutex* pmtSpaceMutex; //Stiti listu slobodnog prostora za PMT
 };
\ No newline at end of file
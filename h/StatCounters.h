@@ -0,0 +1,23 @@
+#pragma once
+#include "ConstantsAndMasks.h"
+#include <atomic>
+
+//Brojaci jedne niti. Brojace menja samo nit kojoj pripadaju, pa se uvecavaju citanjem i upisom bez atomicnog sabiranja,
+//a getStats sabira brojace svih niti. Blokovi brojaca su ulancani u listu koja se menja samo pri prvom pozivu iz nove niti.
+struct StatCounters {
+
+	StatCounters() : accesses(0), hits(0), faults(0), clusterReads(0), next(nullptr) {}
+
+	static void add(std::atomic<unsigned long>& counter, unsigned long amount = 1) {
+		counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+
+	std::atomic<unsigned long> accesses; //Pozivi access-a i adrese u accessBatch-u
+	std::atomic<unsigned long> hits; //Pristupi stranici koja je bila u memoriji
+	std::atomic<unsigned long> faults; //Pristupi koji su vratili PAGE_FAULT
+	std::atomic<unsigned long> clusterReads; //Klasteri procitani sa diska pri ucitavanju stranica, bez stranica iz kesa kompresovanih stranica
+
+	StatCounters* next;
+
+	char padding[CACHE_LINE_SIZE]; //Brojaci razlicitih niti nisu u istoj kes liniji
+};
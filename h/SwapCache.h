@@ -0,0 +1,62 @@
+#pragma once
+#include "vm_declarations.h"
+#include "ConstantsAndMasks.h"
+#include "SystemStats.h"
+#include "part.h"
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class KernelSystem;
+
+//Kes kompresovanih stranica izmedju sistema i particije. Stranica koja se upisuje na klaster se kompresuje i cuva u kesu
+//pod brojem klastera, a citanje klastera prvo trazi stranicu u kesu. Kad kompresovane stranice predju zadatu velicinu, najduze
+//nekoriscene stranice se upisuju na svoje klastere, sortirane po klasterima, i brisu iz kesa. Stranica u kesu je uvek novija od
+//sadrzaja njenog klastera, pa se iz kesa izbacuje samo upisom na disk.
+class SwapCache {
+public:
+	SwapCache(KernelSystem* system, size_t capacity, PageNum writebackBatch);
+
+	~SwapCache();
+
+	//Kompresuje stranice sortirane po klasterima u kes. Stranice koje se ne kompresuju dovoljno se upisuju direktno na disk.
+	bool write(const std::vector<std::pair<ClusterNo, const char*>>& pages);
+
+	//Cita count susednih klastera od first, i-ti klaster u buffers[i]. Klasteri kojih nema u kesu se citaju sa diska,
+	//a diskReads je broj takvih klastera.
+	bool read(ClusterNo first, ClusterNo count, char* const* buffers, ClusterNo& diskReads);
+
+	void invalidate(ClusterNo cluster); //Klaster je oslobodjen, njegova stranica u kesu vise nije potrebna
+
+	SwapCacheStats getStats();
+
+private:
+	struct Entry {
+		char* data = nullptr;
+		size_t size = 0;
+		std::list<ClusterNo>::iterator lru;
+	};
+
+	void erase(std::unordered_map<ClusterNo, Entry>::iterator entry);
+
+	void shrink(); //Upisuje najduze nekoriscene stranice na disk dok kes ne bude manji od capacity, najmanje writebackBatch stranica
+
+	KernelSystem* system;
+
+	size_t capacity;
+
+	PageNum writebackBatch;
+
+	std::unordered_map<ClusterNo, Entry> entries;
+
+	std::list<ClusterNo> lru; //Klasteri stranica u kesu, na pocetku je poslednja upisana ili procitana stranica
+
+	size_t used; //Bajtovi kompresovanih stranica
+
+	SwapCacheStats stats;
+
+	std::mutex* mutex; //Ne uzima nijedno drugo zakljucavanje sistema, pa se uzima i pod evictionMutex-om
+};
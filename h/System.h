@@ -1,6 +1,9 @@
 #pragma once
 // File: System.h
 #include "vm_declarations.h"
+#include "AccessRequest.h"
+#include "SystemConfig.h"
+#include "SystemStats.h"
 
 class Partition;
 class Process;
@@ -11,6 +14,9 @@ public:
 	System(PhysicalAddress processVMSpace, PageNum processVMSpaceSize,
 		PhysicalAddress pmtSpace, PageNum pmtSpaceSize,
 		Partition* partition);
+	System(PhysicalAddress processVMSpace, PageNum processVMSpaceSize,
+		PhysicalAddress pmtSpace, PageNum pmtSpaceSize,
+		Partition* partition, const SystemConfig& config);
 	~System();
 	Process* createProcess();
 
@@ -18,7 +24,24 @@ public:
 
 	Status access(ProcessId pid, VirtualAddress address, AccessType type);
 
+	//Pristupa svim adresama, ucitava stranice koje nisu u memoriji i u results upisuje status i fizicku adresu za svaku.
+	//Vraca OK ako su svi pristupi uspeli, a TRAP ako neki nije dozvoljen.
+	Status accessBatch(ProcessId pid, const AccessRequest* requests, PageNum count, AccessResult* results);
+
 	Process* cloneProcess(ProcessId pid);
+
+	WritebackStats getWritebackStats();
+
+	PrefetchStats getPrefetchStats(); //Odnos pogodaka i ucitanih unapred stranica je uspesnost ucitavanja unapred
+
+	//Brojaci pristupa, izbacivanja i rada sa particijom, zauzece frejmova, klastera i pmtSpace-a i broj stranica svakog procesa
+	SystemStats getStats();
+
+	//Snimanje poziva access, accessBatch, periodicJob i metoda procesa za segmente, page fault i kloniranje u fajl, za ponovno
+	//izvrsavanje programom tools/AccessReplay.cpp. Pozivaju se kad nijedna nit ne koristi sistem, najbolje pre kreiranja procesa.
+	bool startRecording(const char* fileName);
+
+	bool stopRecording(); //Vraca false ako snimanje nije bilo pokrenuto ili upis u fajl nije uspeo
 private:
 
 
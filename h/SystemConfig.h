@@ -0,0 +1,31 @@
+#pragma once
+#include "vm_declarations.h"
+#include "ConstantsAndMasks.h"
+#include <cstddef>
+
+enum ReplacementPolicyType { CLOCK, CLOCK_PRO, ARC, TWO_QUEUE, LRU_K };
+
+//Parametri sistema koji se zadaju pri njegovom kreiranju
+struct SystemConfig {
+	Time agingPeriod = DEFAULT_AGING_PERIOD; //Period izmedju dva poziva periodicJob-a, u mikrosekundama
+
+	ReplacementPolicyType replacementPolicy = ReplacementPolicyType::CLOCK; //Algoritam zamene stranica
+
+	unsigned int lruK = DEFAULT_LRU_K; //Broj poslednjih referenci koje pamti LRU-K algoritam
+
+	PageNum swapBatchSize = DEFAULT_SWAP_BATCH_SIZE; //Broj stranica koje swapPage izbacuje odjednom
+
+	unsigned int writebackStartRatio = DEFAULT_WRITEBACK_START_RATIO; //Procenat modifikovanih frejmova od kog periodicJob upisuje neaktivne stranice na disk
+
+	unsigned int writebackUrgentRatio = DEFAULT_WRITEBACK_URGENT_RATIO; //Procenat modifikovanih frejmova od kog se upisuju sve neaktivne stranice, bez ogranicenja broja po pozivu
+
+	PageNum writebackBatchSize = DEFAULT_WRITEBACK_BATCH_SIZE; //Najveci broj stranica koje jedan poziv periodicJob-a upisuje, 0 iskljucuje upis u pozadini
+
+	PageNum faultAroundPages = DEFAULT_FAULT_AROUND_PAGES; //Najveci broj susednih izbacenih stranica segmenta koje page fault ucitava istim citanjem, 0 iskljucuje ucitavanje unapred
+
+	size_t swapCacheSize = DEFAULT_SWAP_CACHE_SIZE; //Najveci broj bajtova kompresovanih stranica u kesu ispred particije, 0 iskljucuje kes
+
+	PageNum swapCacheWritebackBatch = DEFAULT_SWAP_CACHE_WRITEBACK_BATCH; //Najmanji broj stranica koje kes upisuje na disk odjednom
+
+	bool mapPartition = false; //Da li se fajl particije mapira u memoriju, ako platforma to ne podrzava koriste se obicni pozivi
+};
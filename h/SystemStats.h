@@ -0,0 +1,95 @@
+#pragma once
+#include "vm_declarations.h"
+#include "part.h"
+#include <cstddef>
+#include <vector>
+
+//Brojaci upisa stranica na disk. Stranica upisana pri izbacivanju se upisuje dok proces ceka na
+//obradu page fault-a, a upis u pozadini se radi iz periodicJob-a.
+struct WritebackStats {
+	unsigned long backgroundWrites = 0; //Stranice upisane na disk iz periodicJob-a
+
+	unsigned long evictionWrites = 0; //Modifikovane stranice upisane na disk pri izbacivanju
+
+	unsigned long cleanEvictions = 0; //Izbacene stranice koje nije trebalo upisati na disk
+
+	unsigned long savedWrites = 0; //Izbacene stranice koje nije trebalo upisati zato sto su vec upisane u pozadini
+};
+
+//Brojaci stranica koje page fault ucitava unapred uz trazenu stranicu. Stranica je pogodak ako joj proces
+//pristupi dok je u memoriji, a neiskoriscena ako bude izbacena ili obrisana pre prvog pristupa.
+struct PrefetchStats {
+	unsigned long prefetched = 0;
+
+	unsigned long hits = 0;
+
+	unsigned long unused = 0;
+};
+
+//Brojaci kesa kompresovanih stranica ispred particije. Stranica upisana iz kesa na disk je izbacena iz kesa.
+struct SwapCacheStats {
+	unsigned long stores = 0; //Stranice kompresovane u kes pri upisu na klaster
+
+	unsigned long rejected = 0; //Stranice upisane direktno na disk jer se nisu dovoljno kompresovale
+
+	unsigned long hits = 0; //Klasteri procitani iz kesa
+
+	unsigned long misses = 0; //Klasteri procitani sa diska
+
+	unsigned long writebacks = 0; //Stranice upisane iz kesa na disk
+
+	PageNum pages = 0;
+
+	size_t bytes = 0; //Bajtovi kompresovanih stranica u kesu
+
+	size_t capacity = 0;
+};
+
+//Broj stranica jednog procesa u memoriji i na disku. Stranice deljenog segmenta se broje kod svakog procesa koji ga koristi.
+struct ProcessStats {
+	ProcessId pid = 0;
+
+	PageNum residentPages = 0;
+
+	PageNum swappedPages = 0; //Izbacene stranice koje se pri sledecem pristupu citaju sa diska
+};
+
+//Stanje sistema u trenutku poziva getStats. Brojaci pristupa i citanja klastera se vode za svaku nit posebno, pa pristup
+//ne uzima zakljucavanje zbog brojaca, a izbacivanja i upisi klastera se broje pod evictionMutex-om.
+struct SystemStats {
+	unsigned long accesses = 0;
+
+	unsigned long hits = 0; //Pristupi stranici u memoriji
+
+	unsigned long faults = 0; //Pristupi koji su vratili PAGE_FAULT, velik odnos prema accesses znaci da sistem stalno izbacuje stranice
+
+	unsigned long evictions = 0; //Izbacene stranice, velika stranica se broji kao SUPERPAGE_SIZE stranica
+
+	unsigned long cleanEvictions = 0;
+
+	unsigned long dirtyEvictions = 0; //Izbacene stranice upisane na disk pri izbacivanju
+
+	unsigned long clusterReads = 0;
+
+	unsigned long clusterWrites = 0; //Upisi pri izbacivanju i upisi u pozadini, sa kesom kompresovanih stranica su to upisi u kes
+
+	PageNum freeFrames = 0;
+
+	PageNum totalFrames = 0;
+
+	ClusterNo freeClusters = 0;
+
+	ClusterNo totalClusters = 0;
+
+	size_t pmtSpaceUsed = 0; //Bajtovi u tabelama stranica i deskriptorima koji su dodeljeni
+
+	size_t pmtSpaceSize = 0;
+
+	size_t pmtFreeRegions = 0; //Nepovezani slobodni delovi pmtSpace-a van slabova, mera fragmentacije
+
+	size_t pmtLargestFreeRegion = 0; //Najveca tabela deljenog segmenta koja moze da se dodeli, u bajtovima
+
+	SwapCacheStats swapCache; //Sve nule ako kes nije ukljucen
+
+	std::vector<ProcessStats> processes;
+};
@@ -0,0 +1,132 @@
+#pragma once
+#include "vm_declarations.h"
+#include "ConstantsAndMasks.h"
+#include <atomic>
+
+//Tragovi umesto ispisa na std::cout. Dogadjaj se upisuje u binarnom obliku u kruzni bafer niti koja ga prijavljuje,
+//bez zakljucavanja, a Trace::dump upisuje dogadjaje svih niti u fajl koji se cita programom tools/TraceDecoder.cpp:
+//	g++ -std=c++14 -Ih -Ipart tools/TraceDecoder.cpp src/Trace.cpp -o traceDecoder
+//Makroi TRACE_ERROR, TRACE_INFO i TRACE_DEBUG se ne prevode ako je nivo veci od TRACE_LEVEL, ni njihovi argumenti.
+
+enum class TraceEvent : unsigned short {
+	//TRACE_LEVEL_ERROR
+	SEGMENT_NO_MEMORY,
+	LOAD_SEGMENT_WRITE_FAILED,
+	LOAD_SEGMENT_NO_MEMORY,
+	DELETE_SEGMENT_NOT_ALIGNED,
+	DELETE_SEGMENT_NOT_ALLOCATED,
+	DELETE_SEGMENT_NOT_FIRST_PAGE,
+	DELETE_SEGMENT_SHARED,
+	PAGE_FAULT_NO_MEMORY,
+	PMT1_NO_SPACE,
+	SUPERPAGE_ALLOCATED,
+	SPLIT_SUPERPAGE_NO_SPACE,
+	COPY_ON_WRITE_NO_MEMORY,
+	PHYSICAL_ADDRESS_UNMAPPED,
+	SHARED_SEGMENT_NO_MEMORY,
+	SHARED_SEGMENT_SIZE_MISMATCH,
+	SHARED_SEGMENT_RIGHTS_MISMATCH,
+	DISCONNECT_NO_SEGMENT,
+	DISCONNECT_NOT_CONNECTED,
+	DISCONNECT_PMT_ERROR,
+	DELETE_SHARED_NO_SEGMENT,
+	SEGMENT_NOT_ALIGNED,
+	SEGMENT_OUT_OF_RANGE,
+	SEGMENT_EMPTY,
+	SEGMENT_OVERLAP,
+	UPDATE_PMT_ALLOCATED,
+	UPDATE_PMT_NO_SPACE,
+	WRITEBACK_WRITE_FAILED,
+	CLONE_NO_PROCESS,
+	CLONE_NO_PMT_SPACE,
+	CLONE_NO_COW_SPACE,
+	SWAP_CACHE_WRITE_FAILED,
+	SWAP_CACHE_DECOMPRESS_FAILED,
+
+	//TRACE_LEVEL_INFO
+	ACCESS_NO_PROCESS,
+	ACCESS_NO_PMT1,
+	ACCESS_NO_PMT2,
+	ACCESS_NOT_LOADED,
+	ACCESS_NO_RIGHTS,
+	ACCESS_BATCH_NO_PROCESS,
+	PAGE_FAULT_NOT_LOADED,
+
+	//TRACE_LEVEL_DEBUG
+	ACCESS_PAGE_FAULT,
+	PAGE_FAULT_DISK_READ,
+	PAGE_FAULT_LOADED,
+
+	EVENT_COUNT
+};
+
+//Dogadjaj u baferu i u fajlu. Znacenje argumenata zavisi od dogadjaja i opisano je u TraceEventInfo.
+struct TraceRecord {
+	unsigned long long time; //Nanosekunde od pokretanja racunara, steady_clock
+	unsigned long long args[2];
+	ProcessId pid;
+	TraceEvent event;
+	unsigned short thread; //Redni broj niti u tragovima, od 1
+};
+
+struct TraceEventInfo {
+	int level;
+	const char* message;
+	const char* args[2]; //Imena argumenata, nullptr za argument koji dogadjaj ne koristi
+};
+
+//Zaglavlje fajla koji pravi Trace::dump, iza njega su dogadjaji sortirani po vremenu
+struct TraceFileHeader {
+	char magic[8];
+	unsigned int recordSize;
+	unsigned int threads;
+	unsigned long long records;
+	unsigned long long lost; //Dogadjaji prepisani u kruznim baferima pre poziva dump-a
+};
+
+#define TRACE_FILE_MAGIC "VMTRACE"
+
+#define TRACE_RECORD_WORDS (sizeof(TraceRecord) / sizeof(unsigned long long))
+
+static_assert(sizeof(TraceRecord) % sizeof(unsigned long long) == 0, "TraceRecord se upisuje u baferu po recima");
+
+//Kruzni bafer jedne niti. Samo nit vlasnik upisuje dogadjaje, a dump cita bafer dok nit nastavlja da upisuje i odbacuje
+//dogadjaje koje je nit mozda prepisala tokom citanja. Dogadjaj se zato cuva kao atomicne reci, pa citanje reci koju nit
+//upravo menja nije trka podataka, a dump posle kopiranja ponovo cita head da bi prepoznao takve dogadjaje.
+struct TraceBuffer {
+	std::atomic<unsigned long long> records[TRACE_BUFFER_SIZE][TRACE_RECORD_WORDS];
+	std::atomic<unsigned long long> head; //Broj upisanih dogadjaja, sledeci se upisuje na head % TRACE_BUFFER_SIZE
+	unsigned short thread;
+	TraceBuffer* next;
+};
+
+class Trace {
+public:
+	static void record(TraceEvent event, ProcessId pid, unsigned long long arg0 = 0, unsigned long long arg1 = 0);
+
+	//Upisuje dogadjaje iz bafera svih niti u fajl, bafere ne prazni. Vraca false ako fajl ne moze da se upise.
+	static bool dump(const char* fileName);
+
+	static const TraceEventInfo& getEventInfo(TraceEvent event);
+
+private:
+	static TraceBuffer* addBuffer(); //Bafer niti koja prvi put prijavljuje dogadjaj
+};
+
+#if TRACE_LEVEL >= TRACE_LEVEL_ERROR
+#define TRACE_ERROR(event, ...) Trace::record(TraceEvent::event, __VA_ARGS__)
+#else
+#define TRACE_ERROR(event, ...) ((void)0)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_INFO
+#define TRACE_INFO(event, ...) Trace::record(TraceEvent::event, __VA_ARGS__)
+#else
+#define TRACE_INFO(event, ...) ((void)0)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_DEBUG
+#define TRACE_DEBUG(event, ...) Trace::record(TraceEvent::event, __VA_ARGS__)
+#else
+#define TRACE_DEBUG(event, ...) ((void)0)
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+#include "ReplacementPolicy.h"
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+//2Q (Johnson, Shasha 1994). Nova stranica ulazi u FIFO red A1in, a kljuc stranice izbacene iz A1in
+//se pamti u redu A1out. U glavni red Am ulazi samo stranica koja je ponovo trazena dok je bila u
+//A1out, pa jednokratni sken ne izbacuje stranice iz Am. Am je umesto LRU liste organizovan kao sat.
+class TwoQueuePolicy : public ReplacementPolicy {
+public:
+	TwoQueuePolicy(PageNum numberOfFrames);
+
+	~TwoQueuePolicy();
+
+	void pageAccessed(PageNum frame) override;
+
+	void pageLoaded(PageNum frame, PageKey key) override;
+
+	PageNum selectVictim() override;
+
+	void pageEvicted(PageNum frame) override;
+
+	void frameFreed(PageNum frame) override;
+
+	bool isIdle(PageNum frame) const override;
+
+private:
+
+	enum QueueType { NONE, A1_IN, AM };
+
+	PageNum numberOfFrames;
+
+	PageNum inLimit, outLimit; //Kin i Kout
+
+	std::list<PageNum> a1in, am; //Pocetak A1in je najstarija stranica, pocetak Am je pozicija kazaljke
+
+	std::list<PageKey> a1out; //Pocetak liste je najskorije izbacena stranica
+
+	std::unordered_map<PageKey, std::list<PageKey>::iterator> a1outMap;
+
+	std::list<PageNum>::iterator* entries;
+
+	QueueType* queue;
+
+	PageKey* keys;
+
+	std::atomic<bool>* referenced; //Postavlja se u pageAccessed bez zakljucavanja
+};
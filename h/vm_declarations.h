@@ -11,7 +11,7 @@ enum Status { OK, PAGE_FAULT, TRAP };
 
 enum AccessType { READ, WRITE, READ_WRITE, EXECUTE };
 
-enum PMTType { LEVEL1_PMT, LEVEL2_PMT, SHARED_SEG_PMT };
+enum PMTType { LEVEL1_PMT, LEVEL2_PMT, SHARED_SEG_PMT, COW_DESCRIPTOR };
 
 typedef unsigned ProcessId;
 
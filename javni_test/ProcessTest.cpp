@@ -7,7 +7,8 @@
 
 #define POWER_OF_NUMBER_OF_INSTRUCTIONS (15)
 
-ProcessTest::ProcessTest(System &system, SystemTest &systemTest_) : systemTest(systemTest_), finished(false) {
+ProcessTest::ProcessTest(System &system, SystemTest &systemTest_, const std::vector<AccessDistribution> &distributions_)
+        : systemTest(systemTest_), distributions(distributions_), finished(false) {
     process = system.createProcess();
 
     VirtualAddress address;
@@ -20,7 +21,7 @@ ProcessTest::ProcessTest(System &system, SystemTest &systemTest_) : systemTest(s
         throw std::exception();
     }
 
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < NUMBER_OF_DATA_SEGMENTS; i++) {
         address += PAGE_SIZE * (size + 1);
         address = alignToPage(address);
         if (OK != addDataSegment(address, size)) {
@@ -132,7 +133,7 @@ void ProcessTest::run() {
 
     for (int i = 0; i < (1 << POWER_OF_NUMBER_OF_INSTRUCTIONS); i++) {
         for (int j = 2; j < checkMemory.size(); j++) {
-            std::vector<VirtualAddress> numbers = rN.getRandomNumbers(limits, j);
+            std::vector<VirtualAddress> numbers = rN.getRandomNumbers(limits, distributions, j);
             std::vector<std::tuple<VirtualAddress, AccessType, char>> addresses;
 
             addresses.emplace_back(numbers[0], EXECUTE, readFromAddress(numbers[0]));
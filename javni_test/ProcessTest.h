@@ -5,12 +5,18 @@
 #include <vector>
 #include "vm_declarations.h"
 #include "Process.h"
+#include "RandomNumberGenerator.h"
+
+#define NUMBER_OF_DATA_SEGMENTS (10) // Data segments created after the code segment of every process
 
 class SystemTest;
 
 class ProcessTest {
 public:
-    explicit ProcessTest(System& system, SystemTest& systemTest_);
+    // distributions[0] drives the code segment and distributions[1..NUMBER_OF_DATA_SEGMENTS] the data segments,
+    // see AccessDistribution
+    explicit ProcessTest(System& system, SystemTest& systemTest_,
+                         const std::vector<AccessDistribution>& distributions_ = std::vector<AccessDistribution>());
     Status addCodeSegment(VirtualAddress address, PageNum size);
     Status addDataSegment(VirtualAddress address, PageNum size);
     void writeToAddress(VirtualAddress address, char value);
@@ -32,6 +38,7 @@ private:
     std::vector<std::tuple<MemoryBackup, VirtualAddress, PageNum>> checkMemory;
     Process *process;
     SystemTest &systemTest;
+    std::vector<AccessDistribution> distributions;
     bool finished;
 };
 
@@ -1,5 +1,97 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include "RandomNumberGenerator.h"
 
+AccessDistribution AccessDistribution::uniform() {
+    return AccessDistribution();
+}
+
+AccessDistribution AccessDistribution::zipf(double skew) {
+    AccessDistribution distribution;
+    distribution.pattern = AccessPattern::ZIPF;
+    distribution.skew = skew;
+    return distribution;
+}
+
+AccessDistribution AccessDistribution::hotSet(double hotFraction, double hotProbability) {
+    AccessDistribution distribution;
+    distribution.pattern = AccessPattern::HOT_SET;
+    distribution.hotFraction = hotFraction;
+    distribution.hotProbability = hotProbability;
+    return distribution;
+}
+
+AccessDistribution AccessDistribution::sequential(VirtualAddress stride) {
+    AccessDistribution distribution;
+    distribution.pattern = AccessPattern::SEQUENTIAL;
+    distribution.stride = stride;
+    return distribution;
+}
+
+AccessDistribution AccessDistribution::strided(VirtualAddress stride) {
+    AccessDistribution distribution;
+    distribution.pattern = AccessPattern::STRIDED;
+    distribution.stride = stride;
+    return distribution;
+}
+
+AccessDistribution AccessDistribution::loop(PageNum pages) {
+    AccessDistribution distribution;
+    distribution.pattern = AccessPattern::LOOP;
+    distribution.loopPages = pages;
+    return distribution;
+}
+
+AccessDistribution AccessDistribution::phases(PageNum workingSetPages, unsigned long phaseLength) {
+    AccessDistribution distribution;
+    distribution.pattern = AccessPattern::PHASE;
+    distribution.workingSetPages = workingSetPages;
+    distribution.phaseLength = phaseLength;
+    return distribution;
+}
+
+bool AccessDistribution::parse(const std::string &text, AccessDistribution &distribution) {
+    std::vector<std::string> fields;
+    for (size_t start = 0, end; start <= text.size(); start = end + 1) {
+        end = text.find(':', start);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        fields.push_back(text.substr(start, end - start));
+    }
+
+    auto number = [&](size_t i, double defaultValue) {
+        return i < fields.size() ? std::atof(fields[i].c_str()) : defaultValue;
+    };
+
+    const std::string &name = fields[0];
+    distribution = AccessDistribution();
+
+    if (name == "uniform") {
+        distribution = uniform();
+    } else if (name == "zipf") {
+        distribution = zipf(number(1, distribution.skew));
+    } else if (name == "hot") {
+        distribution = hotSet(number(1, distribution.hotFraction), number(2, distribution.hotProbability));
+    } else if (name == "seq") {
+        distribution = sequential((VirtualAddress) number(1, AccessDistribution::sequentialStride));
+    } else if (name == "stride") {
+        distribution = strided((VirtualAddress) number(1, AccessDistribution::stridedStride));
+    } else if (name == "loop") {
+        distribution = loop((PageNum) number(1, 0));
+    } else if (name == "phase") {
+        distribution = phases((PageNum) number(1, distribution.workingSetPages),
+                              (unsigned long) number(2, distribution.phaseLength));
+    } else {
+        return false;
+    }
+
+    return distribution.stride > 0 && distribution.workingSetPages > 0 && distribution.phaseLength > 0 &&
+           distribution.hotFraction > 0 && distribution.hotFraction <= 1 &&
+           distribution.hotProbability >= 0 && distribution.hotProbability <= 1 && distribution.skew >= 0;
+}
+
 template <typename Number>
 RandomNumberGenerator<Number>::RandomNumberGenerator(int seed) : randomGenerator(seed), mutex() {
 }
@@ -51,4 +143,113 @@ Number RandomNumberGenerator<Number>::getRandomNumber() {
     return randomNumber(randomGenerator);
 }
 
+template <typename Number>
+std::vector<Number>
+RandomNumberGenerator<Number>::getRandomNumbers(const typename RandomNumberGenerator::NumberLimits &limits,
+                                                const std::vector<AccessDistribution> &distributions, int number) {
+    std::lock_guard<std::mutex> guard(mutex);
+
+    static const AccessDistribution uniform;
+    auto distribution = [&](int segment) -> const AccessDistribution & {
+        return (size_t) segment < distributions.size() ? distributions[segment] : uniform;
+    };
+
+    std::vector<Number> ret;
+    ret.emplace_back(getNumberNonThreadSafe(limits, 0, distribution(0)));
+
+    for (int i = 1; i < number; i++) {
+        std::uniform_int_distribution<int> randomLimit(1, limits.size() - 1);
+        int limit = randomLimit(randomGenerator);
+        ret.emplace_back(getNumberNonThreadSafe(limits, limit, distribution(limit)));
+    }
+    return ret;
+}
+
+template <typename Number>
+Number RandomNumberGenerator<Number>::getNumberNonThreadSafe(const typename RandomNumberGenerator::NumberLimits &limits,
+                                                             int segment, const AccessDistribution &distribution) {
+    Number lower = limits[segment].first;
+    Number upper = limits[segment].second;
+
+    if (distribution.pattern == AccessPattern::UNIFORM) { // Draws the same numbers as getRandomNumbers without distributions
+        std::uniform_int_distribution<Number> randomNumber(lower, upper);
+        return randomNumber(randomGenerator);
+    }
+
+    if (segments.size() < limits.size()) {
+        segments.resize(limits.size());
+    }
+    SegmentState &state = segments[segment];
+
+    Number size = upper - lower + 1;
+    PageNum pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+    std::uniform_int_distribution<Number> randomOffset(0, PAGE_SIZE - 1);
+    std::uniform_real_distribution<double> randomProbability(0, 1);
+
+    if ((distribution.pattern == AccessPattern::ZIPF || distribution.pattern == AccessPattern::HOT_SET) &&
+        state.pageOrder.size() != pages) {
+        state.pageOrder.resize(pages);
+        for (PageNum page = 0; page < pages; page++) {
+            state.pageOrder[page] = page;
+        }
+        std::shuffle(state.pageOrder.begin(), state.pageOrder.end(), randomGenerator);
+    }
+
+    Number offset = 0;
+
+    switch (distribution.pattern) {
+        case AccessPattern::ZIPF: {
+            if (state.zipfCdf.size() != pages) {
+                state.zipfCdf.resize(pages);
+                double sum = 0;
+                for (PageNum rank = 0; rank < pages; rank++) {
+                    sum += 1.0 / std::pow(rank + 1, distribution.skew);
+                    state.zipfCdf[rank] = sum;
+                }
+                for (double &value : state.zipfCdf) {
+                    value /= sum;
+                }
+            }
+
+            double probability = randomProbability(randomGenerator);
+            PageNum rank = std::lower_bound(state.zipfCdf.begin(), state.zipfCdf.end(), probability) - state.zipfCdf.begin();
+            offset = state.pageOrder[std::min(rank, pages - 1)] * PAGE_SIZE + randomOffset(randomGenerator);
+            break;
+        }
+        case AccessPattern::HOT_SET: {
+            PageNum hotPages = std::max<PageNum>(1, (PageNum) (pages * distribution.hotFraction));
+            bool hot = hotPages == pages || randomProbability(randomGenerator) < distribution.hotProbability;
+
+            std::uniform_int_distribution<PageNum> randomPage(hot ? 0 : hotPages, hot ? hotPages - 1 : pages - 1);
+            offset = state.pageOrder[randomPage(randomGenerator)] * PAGE_SIZE + randomOffset(randomGenerator);
+            break;
+        }
+        case AccessPattern::SEQUENTIAL:
+        case AccessPattern::STRIDED:
+            offset = state.cursor;
+            state.cursor = (state.cursor + distribution.stride) % size;
+            break;
+        case AccessPattern::LOOP: {
+            PageNum loopPages = (distribution.loopPages == 0) ? pages : std::min(distribution.loopPages, pages);
+            offset = state.cursor * PAGE_SIZE + randomOffset(randomGenerator);
+            state.cursor = (state.cursor + 1) % loopPages;
+            break;
+        }
+        case AccessPattern::PHASE: {
+            if (state.accesses++ % distribution.phaseLength == 0) {
+                std::uniform_int_distribution<PageNum> randomBase(0, pages - 1);
+                state.phaseBase = randomBase(randomGenerator);
+            }
+
+            std::uniform_int_distribution<PageNum> randomPage(0, std::min(distribution.workingSetPages, pages) - 1);
+            offset = ((state.phaseBase + randomPage(randomGenerator)) % pages) * PAGE_SIZE + randomOffset(randomGenerator);
+            break;
+        }
+        default:
+            break;
+    }
+
+    return lower + offset % size; // The last page of a segment can be shorter than PAGE_SIZE
+}
+
 template class RandomNumberGenerator<VirtualAddress>;
@@ -2,12 +2,42 @@
 #define RANDOMNUMBERGENERATOR_H
 
 
+#include <string>
 #include <utility>
 #include <vector>
 #include <random>
 #include <mutex>
 #include "vm_declarations.h"
 
+enum class AccessPattern { UNIFORM, ZIPF, HOT_SET, SEQUENTIAL, STRIDED, LOOP, PHASE };
+
+// How addresses are drawn inside one segment. Fields that the pattern does not use are ignored.
+struct AccessDistribution {
+    AccessPattern pattern = AccessPattern::UNIFORM;
+    double skew = 0.99;                 // ZIPF: the page of rank k is accessed with probability proportional to 1 / k^skew
+    double hotFraction = 0.1;           // HOT_SET: fraction of the segment's pages that are hot
+    double hotProbability = 0.9;        // HOT_SET: probability that an access goes to a hot page
+    static constexpr VirtualAddress sequentialStride = 64;           // SEQUENTIAL: default stride, the next word of the page
+    static constexpr VirtualAddress stridedStride = PAGE_SIZE + 64;  // STRIDED: default stride, a word on the next page
+
+    VirtualAddress stride = sequentialStride; // SEQUENTIAL, STRIDED: bytes between two consecutive accesses
+    PageNum loopPages = 0;              // LOOP: pages visited in order before starting over, 0 for the whole segment
+    PageNum workingSetPages = 16;       // PHASE: pages accessed uniformly during one phase
+    unsigned long phaseLength = 10000;  // PHASE: accesses before the working set moves to another part of the segment
+
+    static AccessDistribution uniform();
+    static AccessDistribution zipf(double skew);
+    static AccessDistribution hotSet(double hotFraction, double hotProbability);
+    static AccessDistribution sequential(VirtualAddress stride = sequentialStride);
+    static AccessDistribution strided(VirtualAddress stride = stridedStride);
+    static AccessDistribution loop(PageNum pages);
+    static AccessDistribution phases(PageNum workingSetPages, unsigned long phaseLength);
+
+    // Parses "uniform", "zipf[:skew]", "hot[:fraction[:probability]]", "seq[:stride]", "stride[:bytes]",
+    // "loop[:pages]" or "phase[:pages[:length]]". Returns false for anything else and for values out of range.
+    static bool parse(const std::string& text, AccessDistribution& distribution);
+};
+
 template <typename Number>
 class RandomNumberGenerator {
 public:
@@ -16,12 +46,26 @@ public:
     Number getRandomNumber(const NumberLimits& limits);
     Number getRandomNumber();
     std::vector<Number> getRandomNumbers(const NumberLimits& limits, int number);
+    // Same as above, but the address in segment i follows distributions[i]. Segments without a distribution are uniform.
+    std::vector<Number> getRandomNumbers(const NumberLimits& limits, const std::vector<AccessDistribution>& distributions,
+                                         int number);
 private:
+    // Position of the SEQUENTIAL, STRIDED, LOOP and PHASE patterns and the page order of ZIPF and HOT_SET in one segment
+    struct SegmentState {
+        Number cursor = 0;
+        unsigned long accesses = 0;
+        PageNum phaseBase = 0;
+        std::vector<double> zipfCdf;
+        std::vector<PageNum> pageOrder; // Hot pages are spread over the segment instead of being next to each other
+    };
+
     Number getRandomNumberNonThreadSafe(const NumberLimits& limits);
+    Number getNumberNonThreadSafe(const NumberLimits& limits, int segment, const AccessDistribution& distribution);
 
     // std::random_device randomDevice;
     std::minstd_rand randomGenerator;
     std::mutex mutex;
+    std::vector<SegmentState> segments;
 };
 
 typedef RandomNumberGenerator<VirtualAddress> VirtualAddressGenerator;
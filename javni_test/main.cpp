@@ -3,6 +3,7 @@
 #include <memory>
 #include <iostream>
 #include <thread>
+#include <vector>
 #include "System.h"
 #include "part.h"
 #include "vm_declarations.h"
@@ -23,7 +24,22 @@ PhysicalAddress alignPointer(PhysicalAddress address) {
     return reinterpret_cast<PhysicalAddress> (addr);
 }
 
-int main() {
+// Every argument is the access pattern of one segment, first for the code segment and then for the data segments,
+// for example "zipf:1.2" or "hot:0.1:0.9" (see AccessDistribution::parse). The last pattern is used for the remaining segments.
+int main(int argc, char **argv) {
+    std::vector<AccessDistribution> distributions;
+    for (int i = 1; i < argc; i++) {
+        AccessDistribution distribution;
+        if (!AccessDistribution::parse(argv[i], distribution)) {
+            std::cout << "Invalid access pattern " << argv[i] << std::endl;
+            return 1;
+        }
+        distributions.push_back(distribution);
+    }
+    if (!distributions.empty()) {
+        distributions.resize(NUMBER_OF_DATA_SEGMENTS + 1, distributions.back()); // The code segment and every data segment
+    }
+
     Partition part("p1.ini");
 
     uint64_t size = (VM_SPACE_SIZE + 2) * PAGE_SIZE;
@@ -42,7 +58,7 @@ int main() {
     std::mutex globalMutex;
 
     for (int i = 0; i < N_PROCESS; i++) {
-		process[i] = new ProcessTest(system, systemTest);
+		process[i] = new ProcessTest(system, systemTest, distributions);
     }
 	
 	for (int i = 0; i < N_PROCESS; i++) {
@@ -0,0 +1,341 @@
+#include "part.h"
+
+#ifdef _WIN32
+
+//Na Windows-u je particija implementirana u part.lib, ovde se nalaze samo metode koje
+//biblioteka ne sadrzi. One citaju i upisuju klaster po klaster.
+
+Partition::Partition(const char *name, unsigned int flags) : Partition(name) {
+}
+
+int Partition::readClusters(ClusterNo first, ClusterNo count, char *const *buffers) {
+	for (ClusterNo i = 0; i < count; i++) {
+		if (!this->readCluster(first + i, buffers[i])) return 0;
+	}
+	return 1;
+}
+
+int Partition::writeClusters(ClusterNo first, ClusterNo count, const char *const *buffers) {
+	for (ClusterNo i = 0; i < count; i++) {
+		if (!this->writeCluster(first + i, buffers[i])) return 0;
+	}
+	return 1;
+}
+
+int Partition::map() {
+	return 0; //part.lib ne podrzava mapiranje particije
+}
+
+int Partition::flush() {
+	return 1;
+}
+
+#else
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#define DIRECT_IO_ALIGNMENT 512 //Poravnanje bafera i pozicija u fajlu koje zahteva O_DIRECT
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+//Particija nad jednim fajlom. Svi pristupi idu kroz isti deskriptor fajla preko pread/pwrite,
+//koji ne dele poziciju u fajlu, pa nije potreban mutex. Ako je fajl mapiran u memoriju, klasteri
+//se samo kopiraju iz mape ili u nju, a izmene na disk upisuje operativni sistem ili flush.
+class PartitionImpl {
+public:
+	PartitionImpl(const char *iniName, unsigned int flags);
+
+	~PartitionImpl();
+
+	int transfer(ClusterNo first, ClusterNo count, struct iovec *iov, bool write);
+
+	int map();
+
+	int fd;
+
+	ClusterNo numOfClusters;
+
+	bool direct;
+
+	char *mapping; //nullptr ako fajl nije mapiran
+
+private:
+	int transferAligned(ClusterNo first, ClusterNo count, struct iovec *iov, bool write);
+
+	int transferBounced(ClusterNo first, ClusterNo count, struct iovec *iov, bool write);
+};
+
+PartitionImpl::PartitionImpl(const char *iniName, unsigned int flags) : fd(-1), numOfClusters(0), direct(false), mapping(nullptr) {
+	std::ifstream ini(iniName);
+	std::string fileName, sizeLine;
+
+	if (!std::getline(ini, fileName) || !std::getline(ini, sizeLine)) return;
+
+	while (!fileName.empty() && (fileName.back() == '\r' || fileName.back() == ' ' || fileName.back() == '\t')) {
+		fileName.pop_back();
+	}
+
+	ClusterNo clusters = std::strtoul(sizeLine.c_str(), nullptr, 10); //Ostatak linije je komentar
+
+	std::string path(iniName);
+	size_t slash = path.find_last_of('/');
+
+	if (!fileName.empty() && fileName[0] != '/' && slash != std::string::npos) { //Fajl sa podacima je relativan u odnosu na ini fajl
+		fileName = path.substr(0, slash + 1) + fileName;
+	}
+
+	if (flags & PARTITION_DIRECT_IO) {
+		fd = open(fileName.c_str(), O_RDWR | O_DIRECT);
+		direct = (fd >= 0);
+	}
+
+	if (fd < 0) { //Fajl sistem mozda ne podrzava O_DIRECT, tada se radi preko kesa
+		fd = open(fileName.c_str(), O_RDWR); //Fajl se ne kreira ako ne postoji
+	}
+
+	if (fd < 0) return;
+
+	struct stat info;
+	off_t size = (off_t)clusters * ClusterSize;
+
+	if (fstat(fd, &info) != 0 || (info.st_size < size && ftruncate(fd, size) != 0)) { //Prosirivanje fajla do velicine particije
+		close(fd);
+		fd = -1;
+		return;
+	}
+
+	numOfClusters = clusters;
+
+	if (flags & PARTITION_MAPPED) {
+		this->map();
+	}
+}
+
+PartitionImpl::~PartitionImpl() {
+	if (mapping != nullptr) {
+		msync(mapping, (size_t)numOfClusters * ClusterSize, MS_SYNC);
+		munmap(mapping, (size_t)numOfClusters * ClusterSize);
+	}
+
+	if (fd >= 0) close(fd);
+}
+
+int PartitionImpl::map() {
+	if (mapping != nullptr) return 1;
+
+	if (fd < 0 || numOfClusters == 0) return 0;
+
+	void *adr = mmap(nullptr, (size_t)numOfClusters * ClusterSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if (adr == MAP_FAILED) return 0;
+
+	madvise(adr, (size_t)numOfClusters * ClusterSize, MADV_RANDOM); //Klasteri se ne citaju redom, citanje unapred ne pomaze
+
+	mapping = (char*)adr;
+	return 1;
+}
+
+int PartitionImpl::transfer(ClusterNo first, ClusterNo count, struct iovec *iov, bool write) {
+	if (fd < 0 || count == 0 || first >= numOfClusters || count > numOfClusters - first) return 0;
+
+	if (mapping != nullptr) {
+		for (ClusterNo i = 0; i < count; i++) {
+			char *cluster = mapping + (size_t)(first + i) * ClusterSize;
+
+			if (write) std::memcpy(cluster, iov[i].iov_base, ClusterSize);
+			else std::memcpy(iov[i].iov_base, cluster, ClusterSize);
+		}
+		return 1;
+	}
+
+	if (direct) {
+		for (ClusterNo i = 0; i < count; i++) {
+			if ((unsigned long)iov[i].iov_base % DIRECT_IO_ALIGNMENT != 0) {
+				return this->transferBounced(first, count, iov, write);
+			}
+		}
+	}
+
+	return this->transferAligned(first, count, iov, write);
+}
+
+int PartitionImpl::transferAligned(ClusterNo first, ClusterNo count, struct iovec *iov, bool write) {
+	ClusterNo done = 0;
+
+	while (done < count) {
+		int chunk = (count - done > IOV_MAX) ? IOV_MAX : (int)(count - done);
+		off_t offset = (off_t)(first + done) * ClusterSize;
+
+		ssize_t result = write ? pwritev(fd, iov + done, chunk, offset) : preadv(fd, iov + done, chunk, offset);
+
+		if (result < 0) {
+			if (errno == EINTR) continue;
+			return 0;
+		}
+
+		if (result == 0) return 0;
+
+		ClusterNo whole = result / ClusterSize;
+		size_t rest = result % ClusterSize;
+
+		done += whole;
+
+		if (rest != 0) { //Delimican prenos, ostatak klastera se prenosi pojedinacno
+			char *base = (char*)iov[done].iov_base;
+
+			while (rest < ClusterSize) {
+				ssize_t part = write ? pwrite(fd, base + rest, ClusterSize - rest, offset + whole * ClusterSize + rest)
+					: pread(fd, base + rest, ClusterSize - rest, offset + whole * ClusterSize + rest);
+
+				if (part < 0 && errno == EINTR) continue;
+				if (part <= 0) return 0;
+
+				rest += part;
+			}
+			++done;
+		}
+	}
+
+	return 1;
+}
+
+int PartitionImpl::transferBounced(ClusterNo first, ClusterNo count, struct iovec *iov, bool write) {
+	void *bounce = nullptr;
+
+	if (posix_memalign(&bounce, DIRECT_IO_ALIGNMENT, count * ClusterSize) != 0) return 0;
+
+	char *buffer = (char*)bounce;
+
+	if (write) {
+		for (ClusterNo i = 0; i < count; i++) std::memcpy(buffer + i * ClusterSize, iov[i].iov_base, ClusterSize);
+	}
+
+	struct iovec single;
+	single.iov_base = buffer;
+	single.iov_len = count * ClusterSize;
+
+	int result = 1;
+	size_t done = 0;
+	off_t offset = (off_t)first * ClusterSize;
+
+	while (done < single.iov_len) {
+		ssize_t part = write ? pwrite(fd, buffer + done, single.iov_len - done, offset + done)
+			: pread(fd, buffer + done, single.iov_len - done, offset + done);
+
+		if (part < 0 && errno == EINTR) continue;
+		if (part <= 0) {
+			result = 0;
+			break;
+		}
+
+		done += part;
+	}
+
+	if (result && !write) {
+		for (ClusterNo i = 0; i < count; i++) std::memcpy(iov[i].iov_base, buffer + i * ClusterSize, ClusterSize);
+	}
+
+	free(bounce);
+	return result;
+}
+
+Partition::Partition(const char *name) : Partition(name, 0) {
+}
+
+Partition::Partition(const char *name, unsigned int flags) {
+	myImpl = new PartitionImpl(name, flags);
+}
+
+ClusterNo Partition::getNumOfClusters() const {
+	return myImpl->numOfClusters;
+}
+
+int Partition::readCluster(ClusterNo cluster, char *buffer) {
+	struct iovec iov;
+	iov.iov_base = buffer;
+	iov.iov_len = ClusterSize;
+
+	return myImpl->transfer(cluster, 1, &iov, false);
+}
+
+int Partition::writeCluster(ClusterNo cluster, const char *buffer) {
+	struct iovec iov;
+	iov.iov_base = (void*)buffer;
+	iov.iov_len = ClusterSize;
+
+	return myImpl->transfer(cluster, 1, &iov, true);
+}
+
+int Partition::readClusters(ClusterNo first, ClusterNo count, char *const *buffers) {
+	//Niz koji izlazi van particije se odbija pre prenosa prvog dela
+	if (count == 0 || first >= myImpl->numOfClusters || count > myImpl->numOfClusters - first) return 0;
+
+	struct iovec iov[IOV_MAX]; //Dugi nizovi se prenose u delovima od najvise IOV_MAX klastera
+
+	for (ClusterNo done = 0; done < count; ) {
+		ClusterNo chunk = (count - done > IOV_MAX) ? IOV_MAX : count - done;
+
+		for (ClusterNo i = 0; i < chunk; i++) {
+			iov[i].iov_base = buffers[done + i];
+			iov[i].iov_len = ClusterSize;
+		}
+
+		if (!myImpl->transfer(first + done, chunk, iov, false)) return 0;
+		done += chunk;
+	}
+
+	return 1;
+}
+
+int Partition::writeClusters(ClusterNo first, ClusterNo count, const char *const *buffers) {
+	//Niz koji izlazi van particije se odbija pre prenosa prvog dela
+	if (count == 0 || first >= myImpl->numOfClusters || count > myImpl->numOfClusters - first) return 0;
+
+	struct iovec iov[IOV_MAX]; //Dugi nizovi se prenose u delovima od najvise IOV_MAX klastera
+
+	for (ClusterNo done = 0; done < count; ) {
+		ClusterNo chunk = (count - done > IOV_MAX) ? IOV_MAX : count - done;
+
+		for (ClusterNo i = 0; i < chunk; i++) {
+			iov[i].iov_base = (void*)buffers[done + i];
+			iov[i].iov_len = ClusterSize;
+		}
+
+		if (!myImpl->transfer(first + done, chunk, iov, true)) return 0;
+		done += chunk;
+	}
+
+	return 1;
+}
+
+int Partition::map() {
+	return myImpl->map();
+}
+
+int Partition::flush() {
+	if (myImpl->mapping == nullptr) return 1;
+
+	return msync(myImpl->mapping, (size_t)myImpl->numOfClusters * ClusterSize, MS_ASYNC) == 0;
+}
+
+Partition::~Partition() {
+	delete myImpl;
+}
+
+#endif
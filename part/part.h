@@ -3,16 +3,25 @@
 typedef unsigned long ClusterNo;
 const unsigned long ClusterSize = 1024;
 
+enum PartitionFlags { PARTITION_DIRECT_IO = 0x01, PARTITION_MAPPED = 0x02 }; //PARTITION_DIRECT_IO: pristup disku mimo kesa operativnog sistema (O_DIRECT), PARTITION_MAPPED: fajl particije se mapira u memoriju
+
 class PartitionImpl;
 
 class Partition {
 public:
 	Partition(const char *);
+	Partition(const char *, unsigned int flags); //flags je kombinacija vrednosti iz PartitionFlags
 	virtual ClusterNo getNumOfClusters() const; //vraca broj klastera koji pripadaju particiji
 
 	virtual int readCluster(ClusterNo, char *buffer); //cita zadati klaster i u slucaju uspjeha vraca 1; u suprotnom 0
 	virtual int writeCluster(ClusterNo, const char *buffer); //upisuje zadati klaster i u slucaju uspjeha vraca 1; u suprotnom 0
 
+	int readClusters(ClusterNo first, ClusterNo count, char *const *buffers); //cita count susjednih klastera od first, i-ti klaster u buffers[i]; vraca 1 ili 0
+	int writeClusters(ClusterNo first, ClusterNo count, const char *const *buffers); //upisuje count susjednih klastera od first iz buffers; vraca 1 ili 0
+
+	int map(); //mapira fajl particije u memoriju, citanje i upis klastera postaju kopiranje bez sistemskog poziva; vraca 1 ako je particija mapirana
+	int flush(); //zapocinje upis mapiranih izmjena na disk, ne ceka njegov zavrsetak; vraca 1 ili 0
+
 	virtual ~Partition();
 private:
 	PartitionImpl *myImpl;
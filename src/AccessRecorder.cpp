@@ -0,0 +1,438 @@
+#include "AccessRecorder.h"
+#include <cstring>
+
+#define EVENT_HEADER_SIZE 16 //Bajt vrste dogadjaja, redni broj i ID procesa kao varint
+#define VARINT_SIZE 10
+
+std::atomic<unsigned long> AccessRecorder::nextRecorderId(0);
+
+//Bafer niti i redni broj snimka kome pripada, kao kod brojaca niti u KernelSystem-u
+static thread_local AccessTraceBuffer* threadBuffer = nullptr;
+static thread_local unsigned long threadBufferRecorder = 0;
+
+static inline unsigned char* putVarint(unsigned char* out, unsigned long long value) {
+	while (value >= 0x80) {
+		*out++ = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+	*out++ = (unsigned char)value;
+	return out;
+}
+
+static inline unsigned long long zigzag(VirtualAddress address, VirtualAddress last) {
+	long long delta = (long long)(address - last);
+	return ((unsigned long long)delta << 1) ^ (unsigned long long)(delta >> 63);
+}
+
+AccessRecorder::AccessRecorder() : file(nullptr), sequence(0), buffers(nullptr), threads(0), events(0), chunks(0), failed(false) {
+	this->recorderId = ++AccessRecorder::nextRecorderId;
+}
+
+AccessRecorder::~AccessRecorder() {
+	if (this->file != nullptr) this->close();
+
+	while (this->buffers != nullptr) {
+		AccessTraceBuffer* next = this->buffers->next;
+		delete this->buffers;
+		this->buffers = next;
+	}
+}
+
+bool AccessRecorder::open(const char* fileName) {
+	this->file = std::fopen(fileName, "wb");
+	if (this->file == nullptr) return false;
+
+	AccessTraceHeader header; //Brojevi se upisuju pri zatvaranju
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, ACCESS_TRACE_FILE_MAGIC, sizeof(header.magic));
+	header.chunkSize = ACCESS_TRACE_CHUNK_SIZE;
+
+	if (std::fwrite(&header, sizeof(header), 1, this->file) != 1) this->failed = true;
+
+	return !this->failed;
+}
+
+bool AccessRecorder::close() {
+	std::lock_guard<std::mutex> lock(this->fileMutex);
+
+	if (this->file == nullptr) return false;
+
+	for (AccessTraceBuffer* buffer = this->buffers; buffer != nullptr; buffer = buffer->next) {
+		this->flush(buffer);
+	}
+
+	AccessTraceHeader header;
+	std::memcpy(header.magic, ACCESS_TRACE_FILE_MAGIC, sizeof(header.magic));
+	header.chunkSize = ACCESS_TRACE_CHUNK_SIZE;
+	header.threads = this->threads;
+	header.events = this->events;
+	header.chunks = this->chunks;
+
+	if (std::fseek(this->file, 0, SEEK_SET) != 0 || std::fwrite(&header, sizeof(header), 1, this->file) != 1) this->failed = true;
+	if (std::fclose(this->file) != 0) this->failed = true;
+	this->file = nullptr;
+
+	return !this->failed;
+}
+
+AccessTraceBuffer* AccessRecorder::getBuffer() {
+	if (threadBufferRecorder != this->recorderId) {
+		AccessTraceBuffer* buffer = new AccessTraceBuffer();
+		buffer->bytes = 0;
+		buffer->events = 0;
+		buffer->lastSequence = 0;
+		buffer->lastAddress = 0;
+		buffer->pidValid = false;
+
+		std::lock_guard<std::mutex> lock(this->fileMutex);
+		buffer->thread = ++this->threads;
+		buffer->next = this->buffers;
+		this->buffers = buffer;
+
+		threadBuffer = buffer;
+		threadBufferRecorder = this->recorderId;
+	}
+
+	return threadBuffer;
+}
+
+void AccessRecorder::flush(AccessTraceBuffer* buffer) {
+	if (buffer->events > 0) {
+		AccessTraceChunk chunk;
+		chunk.thread = buffer->thread;
+		chunk.bytes = buffer->bytes;
+		chunk.events = buffer->events;
+
+		if (std::fwrite(&chunk, sizeof(chunk), 1, this->file) != 1 || std::fwrite(buffer->data, 1, buffer->bytes, this->file) != buffer->bytes) {
+			this->failed = true;
+		}
+
+		this->events += buffer->events;
+		this->chunks++;
+	}
+
+	buffer->bytes = 0;
+	buffer->events = 0;
+	buffer->lastSequence = 0;
+	buffer->lastAddress = 0;
+	buffer->pidValid = false;
+}
+
+AccessTraceBuffer* AccessRecorder::begin(AccessTraceEvent event, ProcessId pid, unsigned int value, unsigned int size) {
+	AccessTraceBuffer* buffer = this->getBuffer();
+
+	if (buffer->bytes + EVENT_HEADER_SIZE + size > ACCESS_TRACE_CHUNK_SIZE) {
+		std::lock_guard<std::mutex> lock(this->fileMutex);
+		this->flush(buffer);
+	}
+
+	unsigned long long seq = this->sequence.fetch_add(1, std::memory_order_relaxed);
+
+	unsigned char* out = buffer->data + buffer->bytes;
+	bool newPid = !buffer->pidValid || buffer->lastPid != pid;
+
+	*out++ = (unsigned char)event | (newPid ? ACCESS_TRACE_PID : 0) | ((value & ACCESS_TRACE_VALUE_MASK) << ACCESS_TRACE_VALUE_SHIFT);
+	out = putVarint(out, seq - buffer->lastSequence);
+	if (newPid) out = putVarint(out, pid);
+
+	buffer->lastSequence = seq;
+	buffer->lastPid = pid;
+	buffer->pidValid = true;
+	buffer->bytes = (unsigned int)(out - buffer->data);
+	buffer->events++;
+
+	return buffer;
+}
+
+void AccessRecorder::recordAccess(ProcessId pid, VirtualAddress address, AccessType type, Status status) {
+	AccessTraceEvent event = (status == OK) ? AccessTraceEvent::ACCESS : (status == PAGE_FAULT) ? AccessTraceEvent::ACCESS_PAGE_FAULT : AccessTraceEvent::ACCESS_TRAP;
+	AccessTraceBuffer* buffer = this->begin(event, pid, type, VARINT_SIZE);
+
+	unsigned char* out = putVarint(buffer->data + buffer->bytes, zigzag(address, buffer->lastAddress));
+	buffer->lastAddress = address;
+	buffer->bytes = (unsigned int)(out - buffer->data);
+}
+
+void AccessRecorder::recordAccessBatch(ProcessId pid, const AccessRequest* requests, PageNum count, Status status) {
+	for (PageNum first = 0; first < count; first += ACCESS_TRACE_MAX_BATCH) {
+		PageNum part = (count - first < ACCESS_TRACE_MAX_BATCH) ? count - first : ACCESS_TRACE_MAX_BATCH;
+		AccessTraceBuffer* buffer = this->begin(AccessTraceEvent::ACCESS_BATCH, pid, status, VARINT_SIZE * (part + 1));
+
+		unsigned char* out = putVarint(buffer->data + buffer->bytes, part);
+		for (PageNum i = first; i < first + part; i++) { //Tip pristupa je u donja dva bita razlike adresa
+			out = putVarint(out, (zigzag(requests[i].address, buffer->lastAddress) << 2) | requests[i].type);
+			buffer->lastAddress = requests[i].address;
+		}
+		buffer->bytes = (unsigned int)(out - buffer->data);
+	}
+}
+
+void AccessRecorder::recordPageFault(ProcessId pid, VirtualAddress address, Status status) {
+	AccessTraceBuffer* buffer = this->begin(AccessTraceEvent::PAGE_FAULT, pid, status, VARINT_SIZE);
+
+	unsigned char* out = putVarint(buffer->data + buffer->bytes, zigzag(address, buffer->lastAddress));
+	buffer->lastAddress = address;
+	buffer->bytes = (unsigned int)(out - buffer->data);
+}
+
+void AccessRecorder::recordPeriodicJob() {
+	AccessTraceBuffer* buffer = this->getBuffer();
+	this->begin(AccessTraceEvent::PERIODIC_JOB, buffer->pidValid ? buffer->lastPid : 0, 0, 0);
+}
+
+void AccessRecorder::recordProcess(AccessTraceEvent event, ProcessId pid) {
+	this->begin(event, pid, 0, 0);
+}
+
+void AccessRecorder::recordClone(ProcessId pid, ProcessId newPid) {
+	AccessTraceBuffer* buffer = this->begin(AccessTraceEvent::CLONE_PROCESS, pid, 0, VARINT_SIZE);
+
+	unsigned char* out = putVarint(buffer->data + buffer->bytes, newPid);
+	buffer->bytes = (unsigned int)(out - buffer->data);
+}
+
+void AccessRecorder::recordSegment(AccessTraceEvent event, ProcessId pid, VirtualAddress address, PageNum size, AccessType flags, Status status, bool populate, bool superpages) {
+	AccessTraceBuffer* buffer = this->begin(event, pid, flags, 2 * VARINT_SIZE + 1);
+
+	unsigned char* out = putVarint(buffer->data + buffer->bytes, address);
+	out = putVarint(out, size);
+	*out++ = (unsigned char)(status | (populate ? 0x4 : 0) | (superpages ? 0x8 : 0));
+	buffer->bytes = (unsigned int)(out - buffer->data);
+}
+
+void AccessRecorder::recordDeleteSegment(ProcessId pid, VirtualAddress address, Status status) {
+	AccessTraceBuffer* buffer = this->begin(AccessTraceEvent::DELETE_SEGMENT, pid, status, VARINT_SIZE);
+
+	unsigned char* out = putVarint(buffer->data + buffer->bytes, address);
+	buffer->bytes = (unsigned int)(out - buffer->data);
+}
+
+void AccessRecorder::recordSharedSegment(AccessTraceEvent event, ProcessId pid, const char* name, Status status, VirtualAddress address, PageNum size, AccessType flags) {
+	size_t length = std::strlen(name);
+	if (length > ACCESS_TRACE_CHUNK_SIZE / 2) length = ACCESS_TRACE_CHUNK_SIZE / 2; //Ime duze od pola bloka se skracuje
+
+	AccessTraceBuffer* buffer = this->begin(event, pid, flags, 3 * VARINT_SIZE + 1 + (unsigned int)length);
+
+	unsigned char* out = buffer->data + buffer->bytes;
+	*out++ = (unsigned char)status;
+	if (event == AccessTraceEvent::CREATE_SHARED_SEGMENT) {
+		out = putVarint(out, address);
+		out = putVarint(out, size);
+	}
+	out = putVarint(out, length);
+	std::memcpy(out, name, length);
+	buffer->bytes = (unsigned int)(out + length - buffer->data);
+}
+
+AccessTraceReader::AccessTraceReader() : file(nullptr), corrupt(false) {
+	std::memset(&this->header, 0, sizeof(this->header));
+}
+
+AccessTraceReader::~AccessTraceReader() {
+	if (this->file != nullptr) std::fclose(this->file);
+}
+
+bool AccessTraceReader::open(const char* fileName) {
+	this->file = std::fopen(fileName, "rb");
+	if (this->file == nullptr) return false;
+
+	if (std::fread(&this->header, sizeof(this->header), 1, this->file) != 1 ||
+		std::memcmp(this->header.magic, ACCESS_TRACE_FILE_MAGIC, sizeof(this->header.magic)) != 0) {
+		this->corrupt = true;
+		return false;
+	}
+
+	this->cursors.resize(this->header.threads);
+
+	//Prvi prolaz kroz fajl pamti samo pozicije blokova svake niti
+	AccessTraceChunk chunk;
+	for (unsigned long long i = 0; i < this->header.chunks; i++) {
+		long position = std::ftell(this->file);
+
+		if (std::fread(&chunk, sizeof(chunk), 1, this->file) != 1 || chunk.thread == 0 || chunk.thread > this->header.threads ||
+			chunk.bytes > this->header.chunkSize || std::fseek(this->file, chunk.bytes, SEEK_CUR) != 0) {
+			this->corrupt = true;
+			return false;
+		}
+
+		this->cursors[chunk.thread - 1].chunks.push_back(position);
+	}
+
+	for (Cursor& cursor : this->cursors) {
+		cursor.nextChunk = 0;
+		cursor.position = 0;
+		cursor.hasRecord = false;
+		if (!this->advance(cursor) && this->corrupt) return false;
+	}
+
+	return true;
+}
+
+bool AccessTraceReader::isCorrupt() const {
+	return this->corrupt;
+}
+
+const AccessTraceHeader& AccessTraceReader::getHeader() const {
+	return this->header;
+}
+
+bool AccessTraceReader::next(AccessTraceRecord& record) {
+	Cursor* first = nullptr;
+
+	for (Cursor& cursor : this->cursors) { //Niti je malo, pa se najmanji redni broj trazi redom
+		if (cursor.hasRecord && (first == nullptr || cursor.record.sequence < first->record.sequence)) first = &cursor;
+	}
+
+	if (first == nullptr) return false;
+
+	std::swap(record, first->record);
+	this->advance(*first);
+
+	return !this->corrupt;
+}
+
+bool AccessTraceReader::advance(Cursor& cursor) {
+	cursor.hasRecord = false;
+
+	if (cursor.position == cursor.data.size()) { //Ucitavanje sledeceg bloka niti
+		if (cursor.nextChunk == cursor.chunks.size()) return false;
+
+		AccessTraceChunk chunk;
+		if (std::fseek(this->file, cursor.chunks[cursor.nextChunk++], SEEK_SET) != 0 || std::fread(&chunk, sizeof(chunk), 1, this->file) != 1) {
+			this->corrupt = true;
+			return false;
+		}
+
+		cursor.data.resize(chunk.bytes);
+		if (chunk.bytes == 0 || std::fread(cursor.data.data(), 1, chunk.bytes, this->file) != chunk.bytes) {
+			this->corrupt = true;
+			return false;
+		}
+
+		cursor.position = 0;
+		cursor.lastSequence = 0;
+		cursor.lastAddress = 0;
+		cursor.lastPid = 0;
+	}
+
+	if (!this->decode(cursor, cursor.record)) {
+		this->corrupt = true;
+		return false;
+	}
+
+	cursor.record.thread = (unsigned int)(&cursor - this->cursors.data()) + 1;
+	cursor.hasRecord = true;
+	return true;
+}
+
+bool AccessTraceReader::decode(Cursor& cursor, AccessTraceRecord& record) {
+	const unsigned char* in = cursor.data.data() + cursor.position;
+	const unsigned char* end = cursor.data.data() + cursor.data.size();
+	bool valid = true;
+
+	auto getVarint = [&]() -> unsigned long long {
+		unsigned long long value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (in == end) break;
+			unsigned char byte = *in++;
+			value |= (unsigned long long)(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) return value;
+		}
+		valid = false;
+		return 0;
+	};
+
+	auto getAddress = [&](unsigned long long encoded) -> VirtualAddress {
+		long long delta = (long long)(encoded >> 1) ^ -(long long)(encoded & 1);
+		cursor.lastAddress += (VirtualAddress)delta;
+		return cursor.lastAddress;
+	};
+
+	unsigned char kind = *in++;
+	unsigned int value = (kind >> ACCESS_TRACE_VALUE_SHIFT) & ACCESS_TRACE_VALUE_MASK;
+
+	record.event = (AccessTraceEvent)(kind & ACCESS_TRACE_EVENT_MASK);
+	if (record.event >= AccessTraceEvent::EVENT_COUNT) return false;
+
+	cursor.lastSequence += getVarint();
+	if (kind & ACCESS_TRACE_PID) cursor.lastPid = (ProcessId)getVarint();
+
+	record.sequence = cursor.lastSequence;
+	record.pid = cursor.lastPid;
+	record.newPid = 0;
+	record.address = 0;
+	record.size = 0;
+	record.type = READ;
+	record.status = OK;
+	record.populate = false;
+	record.superpages = false;
+	record.requests.clear();
+	record.name.clear();
+
+	switch (record.event) {
+	case AccessTraceEvent::ACCESS:
+	case AccessTraceEvent::ACCESS_PAGE_FAULT:
+	case AccessTraceEvent::ACCESS_TRAP:
+		record.type = (AccessType)value;
+		record.status = (record.event == AccessTraceEvent::ACCESS) ? OK : (record.event == AccessTraceEvent::ACCESS_PAGE_FAULT) ? PAGE_FAULT : TRAP;
+		record.address = getAddress(getVarint());
+		break;
+	case AccessTraceEvent::ACCESS_BATCH: {
+		record.status = (Status)value;
+		unsigned long long count = getVarint();
+		if (count > ACCESS_TRACE_MAX_BATCH) return false;
+
+		record.requests.resize(count);
+		for (AccessRequest& request : record.requests) {
+			unsigned long long encoded = getVarint();
+			request.type = (AccessType)(encoded & 0x3);
+			request.address = getAddress(encoded >> 2);
+		}
+		break;
+	}
+	case AccessTraceEvent::PAGE_FAULT:
+		record.status = (Status)value;
+		record.address = getAddress(getVarint());
+		break;
+	case AccessTraceEvent::CLONE_PROCESS:
+		record.newPid = (ProcessId)getVarint();
+		break;
+	case AccessTraceEvent::CREATE_SEGMENT:
+	case AccessTraceEvent::LOAD_SEGMENT: {
+		record.type = (AccessType)value;
+		record.address = getVarint();
+		record.size = getVarint();
+		if (in == end) return false;
+		unsigned char options = *in++;
+		record.status = (Status)(options & 0x3);
+		record.populate = (options & 0x4) != 0;
+		record.superpages = (options & 0x8) != 0;
+		break;
+	}
+	case AccessTraceEvent::DELETE_SEGMENT:
+		record.status = (Status)value;
+		record.address = getVarint();
+		break;
+	case AccessTraceEvent::CREATE_SHARED_SEGMENT:
+	case AccessTraceEvent::DISCONNECT_SHARED_SEGMENT:
+	case AccessTraceEvent::DELETE_SHARED_SEGMENT: {
+		record.type = (AccessType)value;
+		if (in == end) return false;
+		record.status = (Status)*in++;
+		if (record.event == AccessTraceEvent::CREATE_SHARED_SEGMENT) {
+			record.address = getVarint();
+			record.size = getVarint();
+		}
+		unsigned long long length = getVarint();
+		if (!valid || length > (unsigned long long)(end - in)) return false;
+		record.name.assign((const char*)in, (size_t)length);
+		in += length;
+		break;
+	}
+	default:
+		break;
+	}
+
+	cursor.position = (unsigned int)(in - cursor.data.data());
+	return valid;
+}
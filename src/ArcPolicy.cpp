@@ -0,0 +1,120 @@
+#include "ArcPolicy.h"
+
+ArcPolicy::ArcPolicy(PageNum numberOfFrames) : numberOfFrames(numberOfFrames), target(0) {
+	this->entries = new std::list<PageNum>::iterator[numberOfFrames];
+	this->list = new ListType[numberOfFrames];
+	this->keys = new PageKey[numberOfFrames]{ 0 };
+	this->referenced = new std::atomic<bool>[numberOfFrames]();
+
+	for (PageNum i = 0; i < numberOfFrames; i++) list[i] = ListType::NONE;
+}
+
+ArcPolicy::~ArcPolicy() {
+	delete[] entries;
+	delete[] list;
+	delete[] keys;
+	delete[] referenced;
+}
+
+void ArcPolicy::pageAccessed(PageNum frame) {
+	referenced[frame].store(true, std::memory_order_relaxed);
+}
+
+void ArcPolicy::pageLoaded(PageNum frame, PageKey key) {
+	auto ghost1 = b1Map.find(key);
+	auto ghost2 = b2Map.find(key);
+
+	keys[frame] = key;
+	referenced[frame] = false;
+
+	if (ghost1 != b1Map.end()) { //Promasaj u B1, T1 treba da bude veca
+		PageNum delta = b1.size() >= b2.size() ? 1 : b2.size() / b1.size();
+		target = (target + delta < numberOfFrames) ? target + delta : numberOfFrames;
+
+		this->removeGhost(b1, b1Map, ghost1->second);
+		entries[frame] = t2.insert(t2.end(), frame);
+		list[frame] = ListType::T2;
+		return;
+	}
+
+	if (ghost2 != b2Map.end()) { //Promasaj u B2, T2 treba da bude veca
+		PageNum delta = b2.size() >= b1.size() ? 1 : b1.size() / b2.size();
+		target = (target > delta) ? target - delta : 0;
+
+		this->removeGhost(b2, b2Map, ghost2->second);
+		entries[frame] = t2.insert(t2.end(), frame);
+		list[frame] = ListType::T2;
+		return;
+	}
+
+	//Potpuno nova stranica, ogranicava se velicina direktorijuma pre ubacivanja u T1
+	if (t1.size() + b1.size() >= numberOfFrames && !b1.empty()) {
+		this->removeGhost(b1, b1Map, std::prev(b1.end()));
+	}
+	else if (t1.size() + t2.size() + b1.size() + b2.size() >= 2 * numberOfFrames && !b2.empty()) {
+		this->removeGhost(b2, b2Map, std::prev(b2.end()));
+	}
+
+	entries[frame] = t1.insert(t1.end(), frame);
+	list[frame] = ListType::T1;
+}
+
+PageNum ArcPolicy::selectVictim() {
+	if (t1.empty() && t2.empty()) return this->numberOfFrames;
+
+	while (true) {
+		if (!t1.empty() && (t1.size() >= (target > 1 ? target : 1) || t2.empty())) {
+			PageNum frame = t1.front();
+
+			if (!referenced[frame]) return frame;
+
+			referenced[frame] = false; //Stranica referencirana vise puta prelazi u T2
+			t2.splice(t2.end(), t1, entries[frame]);
+			list[frame] = ListType::T2;
+		}
+		else {
+			PageNum frame = t2.front();
+
+			if (!referenced[frame]) return frame;
+
+			referenced[frame] = false;
+			t2.splice(t2.end(), t2, entries[frame]);
+		}
+	}
+}
+
+void ArcPolicy::pageEvicted(PageNum frame) {
+	auto ghost1 = b1Map.find(keys[frame]); //Kljuc moze ostati u B1 ili B2 ako je stranica u medjuvremenu obrisana i ponovo kreirana
+	if (ghost1 != b1Map.end()) this->removeGhost(b1, b1Map, ghost1->second);
+
+	auto ghost2 = b2Map.find(keys[frame]);
+	if (ghost2 != b2Map.end()) this->removeGhost(b2, b2Map, ghost2->second);
+
+	if (list[frame] == ListType::T1) {
+		b1.push_front(keys[frame]);
+		b1Map.insert({ keys[frame], b1.begin() });
+	}
+	else {
+		b2.push_front(keys[frame]);
+		b2Map.insert({ keys[frame], b2.begin() });
+	}
+
+	this->frameFreed(frame);
+}
+
+void ArcPolicy::frameFreed(PageNum frame) {
+	if (list[frame] == ListType::T1) t1.erase(entries[frame]);
+	else if (list[frame] == ListType::T2) t2.erase(entries[frame]);
+
+	list[frame] = ListType::NONE;
+	referenced[frame] = false;
+}
+
+bool ArcPolicy::isIdle(PageNum frame) const {
+	return !referenced[frame];
+}
+
+void ArcPolicy::removeGhost(std::list<PageKey>& list, std::unordered_map<PageKey, std::list<PageKey>::iterator>& map, std::list<PageKey>::iterator key) {
+	map.erase(*key);
+	list.erase(key);
+}
@@ -0,0 +1,102 @@
+#include "ClockPolicy.h"
+#include "ConstantsAndMasks.h"
+
+ClockPolicy::ClockPolicy(PageNum numberOfFrames) : numberOfFrames(numberOfFrames), clockHand(0) {
+	this->referenceBits = new std::atomic<unsigned char>[(numberOfFrames / REF_BITS_HOLDER_SIZE) + (numberOfFrames % REF_BITS_HOLDER_SIZE == 0 ? 0 : 1)]();
+	this->frameAge = new unsigned char[numberOfFrames]{ 0 };
+	this->loaded = new bool[numberOfFrames]{ false };
+}
+
+ClockPolicy::~ClockPolicy() {
+	delete[] referenceBits;
+	delete[] frameAge;
+	delete[] loaded;
+}
+
+void ClockPolicy::pageAccessed(PageNum frame) {
+	referenceBits[frame / REF_BITS_HOLDER_SIZE].fetch_or(1 << (frame % REF_BITS_HOLDER_SIZE), std::memory_order_relaxed);
+}
+
+void ClockPolicy::pageLoaded(PageNum frame, PageKey key) {
+	this->pagePrefetched(frame, key);
+	this->pageAccessed(frame); //Ucitavanje stranice se racuna kao referenciranje
+}
+
+void ClockPolicy::pagePrefetched(PageNum frame, PageKey) {
+	loaded[frame] = true;
+	frameAge[frame] = 0; //Bez reference je stranica medju najstarijim i prva se izbacuje ako joj se ne pristupi
+}
+
+PageNum ClockPolicy::selectVictim() {
+
+	//Pregleda se SWAP_SCAN_WINDOW frejmova pocevsi od kazaljke i bira se najstarija stranica. Stranica koja
+	//je referencirana od poslednjeg poziva periodicJob-a je mladja od svih ostalih (druga sansa), njen
+	//reference bit se prebacuje u brojac starosti da bi druga sansa vazila i kada se periodicJob ne poziva.
+	PageNum victim = this->numberOfFrames;
+	unsigned int oldest = 0;
+
+	for (PageNum scanned = 0; scanned < this->numberOfFrames; scanned++) {
+		if (scanned >= SWAP_SCAN_WINDOW && victim != this->numberOfFrames) break;
+
+		PageNum frame = this->clockHand;
+		this->clockHand = (this->clockHand + 1) % this->numberOfFrames;
+
+		if (!loaded[frame]) continue;
+
+		unsigned int age = frameAge[frame];
+		if (this->isReferenced(frame)) {
+			age |= AGE_MSB << 1;
+			this->resetReferenced(frame);
+			frameAge[frame] |= AGE_MSB;
+		}
+
+		if (victim == this->numberOfFrames || age < oldest) {
+			victim = frame;
+			oldest = age;
+			if (age == 0) break; //Stranica koja nije koriscena ni u jednom periodu, ne moze se naci starija
+		}
+	}
+
+	return victim;
+}
+
+void ClockPolicy::pageEvicted(PageNum frame) {
+	this->frameFreed(frame);
+}
+
+void ClockPolicy::frameFreed(PageNum frame) {
+	loaded[frame] = false;
+	frameAge[frame] = 0;
+	this->resetReferenced(frame);
+}
+
+bool ClockPolicy::isIdle(PageNum frame) const {
+	return !this->isReferenced(frame) && !(frameAge[frame] & AGE_MSB); //Nije referencirana ni u tekucem ni u prethodnom periodu
+}
+
+void ClockPolicy::periodicJob() {
+
+	//Starenje stranica: reference bit svakog frejma se upisuje u najvisi bit brojaca starosti,
+	//a brojac se pomera udesno. Sto je brojac manji, to stranica duze nije koriscena.
+	//Reference biti jednog bajta se citaju i brisu jednom atomicnom operacijom, pa se referenca
+	//postavljena izmedju citanja i brisanja ne gubi.
+	for (PageNum first = 0; first < this->numberOfFrames; first += REF_BITS_HOLDER_SIZE) {
+		unsigned char bits = referenceBits[first / REF_BITS_HOLDER_SIZE].exchange(0, std::memory_order_relaxed);
+
+		for (PageNum frame = first; frame < first + REF_BITS_HOLDER_SIZE && frame < this->numberOfFrames; frame++) {
+			frameAge[frame] >>= 1;
+
+			if (bits & (1 << (frame % REF_BITS_HOLDER_SIZE))) {
+				frameAge[frame] |= AGE_MSB;
+			}
+		}
+	}
+}
+
+bool ClockPolicy::isReferenced(PageNum frame) const {
+	return (referenceBits[frame / REF_BITS_HOLDER_SIZE].load(std::memory_order_relaxed) & (1 << (frame % REF_BITS_HOLDER_SIZE))) != 0;
+}
+
+void ClockPolicy::resetReferenced(PageNum frame) {
+	referenceBits[frame / REF_BITS_HOLDER_SIZE].fetch_and(~(1 << (frame % REF_BITS_HOLDER_SIZE)), std::memory_order_relaxed);
+}
@@ -0,0 +1,222 @@
+#include "ClockProPolicy.h"
+
+ClockProPolicy::ClockProPolicy(PageNum numberOfFrames) 
+	: numberOfFrames(numberOfFrames), hotCount(0), coldCount(0) {
+	
+	this->entries = new EntryIterator[numberOfFrames];
+	this->loaded = new bool[numberOfFrames]{ false };
+	this->referenced = new std::atomic<bool>[numberOfFrames]();
+
+	this->coldTarget = numberOfFrames / 100 > 0 ? numberOfFrames / 100 : 1;
+
+	handHot = handCold = handTest = clock.end();
+}
+
+ClockProPolicy::~ClockProPolicy() {
+	delete[] entries;
+	delete[] loaded;
+	delete[] referenced;
+}
+
+void ClockProPolicy::pageAccessed(PageNum frame) {
+	referenced[frame].store(true, std::memory_order_relaxed);
+}
+
+void ClockProPolicy::pageLoaded(PageNum frame, PageKey key) {
+	auto test = nonResident.find(key);
+
+	loaded[frame] = true;
+	referenced[frame] = false;
+
+	if (test != nonResident.end()) { //Stranica je referencirana tokom test perioda, postaje vruca, a hladnim stranicama treba vise prostora
+		this->remove(test->second);
+
+		if (coldTarget < numberOfFrames - 1) ++coldTarget;
+
+		entries[frame] = this->insertAtHead(Entry(key, frame, true, false));
+		++hotCount;
+
+		if (hotCount > numberOfFrames - coldTarget) {
+			this->runHandHot();
+		}
+	}
+	else { //Nova stranica je hladna i pocinje njen test period
+		entries[frame] = this->insertAtHead(Entry(key, frame, false, true));
+		++coldCount;
+	}
+}
+
+PageNum ClockProPolicy::selectVictim() {
+	if (coldCount + hotCount == 0) return this->numberOfFrames;
+
+	for (PageNum scanned = 0; ; scanned++) {
+		if (coldCount == 0 || scanned > 2 * clock.size()) { //Sve stranice u memoriji su vruce, jedna se hladi
+			this->runHandHot();
+			scanned = 0;
+		}
+
+		Entry& entry = *handCold;
+
+		if (entry.hot || entry.frame == numberOfFrames) {
+			this->advance(handCold);
+			continue;
+		}
+
+		if (!referenced[entry.frame]) { //Hladna stranica koja nije referencirana se izbacuje
+			return entry.frame;
+		}
+
+		referenced[entry.frame] = false;
+		EntryIterator current = handCold;
+		this->advance(handCold);
+
+		if (entry.test) { //Referencirana tokom test perioda, postaje vruca
+			entry.hot = true;
+			entry.test = false;
+			--coldCount;
+			++hotCount;
+		}
+		else { //Dobija novi test period
+			entry.test = true;
+		}
+
+		if (current != handHot) { //Premestanje na glavu liste
+			clock.splice(handHot, clock, current);
+		}
+
+		if (hotCount > numberOfFrames - coldTarget) {
+			this->runHandHot();
+		}
+	}
+}
+
+void ClockProPolicy::pageEvicted(PageNum frame) {
+	EntryIterator entry = entries[frame];
+
+	loaded[frame] = false;
+	referenced[frame] = false;
+	--coldCount;
+
+	if (entry->test) { //Stranica u test periodu ostaje u listi kao izbacena
+		auto old = nonResident.find(entry->key); //Kljuc moze ostati u listi ako je stranica u medjuvremenu obrisana i ponovo kreirana
+		if (old != nonResident.end()) this->remove(old->second);
+
+		entry->frame = numberOfFrames;
+		nonResident.insert({ entry->key, entry });
+
+		if (nonResident.size() > numberOfFrames) {
+			this->runHandTest();
+		}
+	}
+	else {
+		this->remove(entry);
+	}
+}
+
+void ClockProPolicy::frameFreed(PageNum frame) {
+	EntryIterator entry = entries[frame];
+
+	if (entry->hot) --hotCount;
+	else --coldCount;
+
+	loaded[frame] = false;
+	referenced[frame] = false;
+	
+	this->remove(entry);
+}
+
+bool ClockProPolicy::isIdle(PageNum frame) const {
+	return !referenced[frame];
+}
+
+ClockProPolicy::EntryIterator ClockProPolicy::insertAtHead(const Entry& entry) {
+	if (clock.empty()) {
+		clock.push_back(entry);
+		handHot = handCold = handTest = clock.begin();
+		return clock.begin();
+	}
+
+	return clock.insert(handHot, entry);
+}
+
+void ClockProPolicy::remove(EntryIterator entry) {
+	if (entry->frame == numberOfFrames) {
+		nonResident.erase(entry->key);
+	}
+
+	if (clock.size() == 1) {
+		clock.clear();
+		handHot = handCold = handTest = clock.end();
+		return;
+	}
+
+	if (handHot == entry) this->advance(handHot);
+	if (handCold == entry) this->advance(handCold);
+	if (handTest == entry) this->advance(handTest);
+
+	clock.erase(entry);
+}
+
+void ClockProPolicy::advance(EntryIterator& hand) {
+	if (++hand == clock.end()) hand = clock.begin();
+}
+
+void ClockProPolicy::runHandHot() {
+
+	//Kazaljka za vruce stranice hladi prvu vrucu stranicu koja nije referencirana, a usput zavrsava
+	//test periode stranica koje prelazi jer su one starije od svih vrucih stranica.
+	for (PageNum scanned = 0; scanned <= 2 * clock.size() && hotCount > 0; scanned++) {
+		if (handHot == handTest) this->advance(handTest); //Kazaljka za vruce stranice gura kazaljku za test period ispred sebe
+
+		EntryIterator current = handHot;
+		Entry& entry = *current;
+
+		if (entry.frame == numberOfFrames) {
+			this->advance(handHot);
+			this->remove(current);
+			continue;
+		}
+
+		if (!entry.hot) {
+			if (entry.test) {
+				entry.test = false;
+				if (coldTarget > 1) --coldTarget;
+			}
+			this->advance(handHot);
+			continue;
+		}
+
+		this->advance(handHot);
+
+		if (referenced[entry.frame]) {
+			referenced[entry.frame] = false;
+			continue;
+		}
+
+		entry.hot = false;
+		--hotCount;
+		++coldCount;
+		return;
+	}
+}
+
+void ClockProPolicy::runHandTest() {
+
+	//Kazaljka za test period zavrsava test periode hladnih stranica i uklanja jednu izbacenu stranicu
+	for (PageNum scanned = 0; scanned <= clock.size(); scanned++) {
+		EntryIterator current = handTest;
+		Entry& entry = *current;
+
+		this->advance(handTest);
+
+		if (entry.hot) continue;
+
+		if (entry.test && coldTarget > 1) --coldTarget;
+		entry.test = false;
+
+		if (entry.frame == numberOfFrames) {
+			this->remove(current);
+			return;
+		}
+	}
+}
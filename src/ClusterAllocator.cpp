@@ -0,0 +1,102 @@
+#include "ClusterAllocator.h"
+#include "MemoryException.h"
+#include <iterator>
+
+ClusterAllocator::ClusterAllocator(ClusterNo numberOfClusters) : numberOfClusters(numberOfClusters), freeClusters(0) {
+	if (numberOfClusters > 0) {
+		this->insertExtent(0, numberOfClusters);
+	}
+}
+
+ClusterNo ClusterAllocator::allocate() {
+	if (extents.empty()) throw MemoryException("Nema slobodnih klastera na disku");
+
+	//Klasteri se dele od pocetka particije, tako da uzastopne alokacije daju susedne klastere
+	return this->takeFromExtent(extents.begin(), 1);
+}
+
+ClusterNo ClusterAllocator::allocateRun(ClusterNo count) {
+	if (count == 0) throw MemoryException("GRESKA: metoda allocateRun | Trazi se niz od 0 klastera");
+
+	auto fit = extentsBySize.lower_bound(std::make_pair(count, (ClusterNo)0)); //Najmanji ekstent u koji niz staje
+
+	if (fit == extentsBySize.end()) throw MemoryException("Nema dovoljno susednih slobodnih klastera na disku");
+
+	return this->takeFromExtent(extents.find(fit->second), count);
+}
+
+void ClusterAllocator::free(ClusterNo cluster) {
+	this->freeRun(cluster, 1);
+}
+
+void ClusterAllocator::freeRun(ClusterNo first, ClusterNo count) {
+	if (count == 0) return;
+
+	if (first >= numberOfClusters || count > numberOfClusters - first) {
+		throw MemoryException("GRESKA: metoda freeRun | Klaster ne postoji na particiji");
+	}
+
+	auto next = extents.lower_bound(first); //Prvi ekstent koji pocinje na first ili posle njega
+
+	if (next != extents.end() && next->first < first + count) {
+		throw MemoryException("GRESKA: metoda freeRun | Klaster je vec slobodan");
+	}
+
+	if (next != extents.begin()) {
+		auto prev = std::prev(next);
+
+		if (prev->first + prev->second > first) {
+			throw MemoryException("GRESKA: metoda freeRun | Klaster je vec slobodan");
+		}
+
+		if (prev->first + prev->second == first) { //Spajanje sa prethodnim ekstentom
+			first = prev->first;
+			count += prev->second;
+			this->eraseExtent(prev);
+		}
+	}
+
+	if (next != extents.end() && next->first == first + count) { //Spajanje sa sledecim ekstentom
+		count += next->second;
+		this->eraseExtent(next);
+	}
+
+	this->insertExtent(first, count);
+}
+
+ClusterNo ClusterAllocator::getFreeClusters() const {
+	return this->freeClusters;
+}
+
+ClusterNo ClusterAllocator::getLargestRun() const {
+	return extentsBySize.empty() ? 0 : extentsBySize.rbegin()->first;
+}
+
+size_t ClusterAllocator::getNumberOfExtents() const {
+	return extents.size();
+}
+
+void ClusterAllocator::insertExtent(ClusterNo first, ClusterNo count) {
+	extents.emplace(first, count);
+	extentsBySize.emplace(count, first);
+	freeClusters += count;
+}
+
+void ClusterAllocator::eraseExtent(std::map<ClusterNo, ClusterNo>::iterator extent) {
+	extentsBySize.erase(std::make_pair(extent->second, extent->first));
+	freeClusters -= extent->second;
+	extents.erase(extent);
+}
+
+ClusterNo ClusterAllocator::takeFromExtent(std::map<ClusterNo, ClusterNo>::iterator extent, ClusterNo count) {
+	ClusterNo first = extent->first;
+	ClusterNo rest = extent->second - count;
+
+	this->eraseExtent(extent);
+
+	if (rest > 0) {
+		this->insertExtent(first + count, rest);
+	}
+
+	return first;
+}
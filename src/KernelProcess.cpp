@@ -6,26 +6,46 @@
 #include "DummyMutex.h"
 #include "Process.h"
 #include "PMT.h"
+#include "Trace.h"
+#include <algorithm>
 #include <cstdlib>
-#include <iostream>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 KernelProcess::KernelProcess(ProcessId pid, Process* myProcess) 
 	:pid(pid), myProcess(myProcess), pmtHead(nullptr) {
 
+	this->pmtMutex = new std::mutex();
 }
 
 KernelProcess::~KernelProcess() {
 	KernelSystem::kernelSystem->deleteProcess(this->pid); //Brise se proces iz mape procesa
+
+	std::unique_lock<std::mutex> sharedLock(*KernelSystem::kernelSystem->sharedSegmentMutex);
+	std::unique_lock<std::mutex> lock(*this->pmtMutex);
+
+	//Odvezivanje deljenih segmenata, deleteSegment ih ne brise pa bi njihovi ulazi ostali zauzeti u PMT-u procesa
+	for (auto& segment : KernelSystem::kernelSystem->sharedSegments) {
+		if (segment.second->processes.count(this->pid) > 0) this->disconnectSharedSegment(segment.first.c_str());
+	}
+
+	sharedLock.unlock();
 	
 	//Dealociranje segmenata koje je proces koristio.
 	for (int i = 0; (i < PMT1_SIZE) && (pmtHead != nullptr) && (pmtHead->entriesUsed > 0); i++) {
-		if (pmtHead->level2entry[i] != nullptr) {
+		if ((pmtHead->level2entry[i] == nullptr) && ((pmtHead->superpage[i].frameAndFlags & (L_MASK | ST_MASK)) == (L_MASK | ST_MASK))) { //Segment pocinje velikom stranicom
+			this->deleteSegment((VirtualAddress)i << PMT1_OFFSET);
+		}
+
+		else if (pmtHead->level2entry[i] != nullptr) {
 
 			PMT2* pmt2 = pmtHead->level2entry[i];
 
-			for (int j = 0; (j < PMT2_SIZE) && (pmt2->entriesUsed > 0); j++) {
-				if ((pmt2->entry[j].frameAndFlags & L_MASK) && (pmt2->entry[j].ordinal == 0)) { //Stranica je ucitana ako je setovan LOAD bit
+			for (int j = 0; (j < PMT2_SIZE) && (pmtHead->level2EntriesUsed[i] > 0); j++) {
+				if ((pmt2->entry[j].frameAndFlags & L_MASK) && (pmt2->entry[j].frameAndFlags & ST_MASK)) { //Stranica je ucitana ako je setovan LOAD bit, a ST bit oznacava pocetak segmenta
 					VirtualAddress adr = (VirtualAddress)i << PMT1_OFFSET;
 					adr |= (VirtualAddress)j << PMT2_OFFSET;
 					this->deleteSegment(adr);
@@ -36,30 +56,61 @@ KernelProcess::~KernelProcess() {
 			}
 		}
 	}
-	pmtHead = nullptr;
+	if (pmtHead != nullptr) { //Tabela prvog nivoa ostaje i kad createSegment ne uspe pre nego sto zauzme neki ulaz
+		KernelSystem::kernelSystem->deallocatePMT(pmtHead, PMTType::LEVEL1_PMT);
+		pmtHead = nullptr;
+	}
+
+	lock.unlock();
+	delete pmtMutex;
 }
 
 ProcessId KernelProcess::getProcessId() const {
 	return this->pid;
 }
 
-Status KernelProcess::createSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags) {
+Status KernelProcess::createSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags, bool populate, bool superpages) {
 
-	this->checkSegment(startAddress, segmentSize);
+	Status status = this->checkSegment(startAddress, segmentSize);
+	if (status != Status::OK) return status;
 
 	for (PageNum i = 0; i < segmentSize; i++) {
 
-		PhysicalAddress frameAddr = nullptr;
-		try { //Dohvatanje jedne stranice
-			frameAddr = KernelSystem::kernelSystem->allocatePage();
+		VirtualAddress page = startAddress + i * PAGE_SIZE;
+
+		//Velika stranica pokriva ceo ulaz tabele prvog nivoa, pa mora da pocinje na njegovom pocetku i da ceo ulaz pripada segmentu
+		if (superpages && !(page & (((VirtualAddress)1 << PMT1_OFFSET) - 1)) && (segmentSize - i >= SUPERPAGE_SIZE)) {
+			PhysicalAddress frameAddr = populate ? KernelSystem::kernelSystem->allocateAlignedRun(SUPERPAGE_SIZE) : nullptr; //Bez poravnatog niza slobodnih frejmova se ucitava pri prvom pristupu
+
+			for (PageNum j = 0; (frameAddr != nullptr) && (j < SUPERPAGE_SIZE); j++) {
+				KernelSystem::kernelSystem->clearContent((char*)frameAddr + j * PAGE_SIZE);
+			}
+
+			if (!this->createSuperpage(page, i, flags, frameAddr)) {
+				if (frameAddr != nullptr) KernelSystem::kernelSystem->deallocatePages(frameAddr, SUPERPAGE_SIZE);
+				return Status::TRAP;
+			}
+
+			i += SUPERPAGE_SIZE - 1;
+			continue;
 		}
 
-		catch (MemoryException e) { //Ako je bilo greske pri dohvatanju stranice, ispisuje se greska i vraca se TRAP.
-			std::cout << e;
-			return Status::TRAP;
+		PhysicalAddress frameAddr = nullptr; //Bez frejma se postavlja samo L bit, a frejm se dodeljuje u pageFault-u
+
+		if (populate) {
+			try { //Dohvatanje jedne stranice
+				frameAddr = KernelSystem::kernelSystem->allocatePage();
+			}
+
+			catch (const MemoryException&) { //Ako je bilo greske pri dohvatanju stranice, ispisuje se greska i vraca se TRAP.
+				TRACE_ERROR(SEGMENT_NO_MEMORY, this->pid, startAddress);
+				return Status::TRAP;
+			}
+
+			KernelSystem::kernelSystem->clearContent((char*)frameAddr);
 		}
 
-		if (!this->updatePMT(startAddress + i * PAGE_SIZE, frameAddr, i, flags, false)) { //Postavljanje odgovarajuceg deskriptora u tabeli stranica
+		if (!this->updatePMT(page, frameAddr, i, flags, false)) { //Postavljanje odgovarajuceg deskriptora u tabeli stranica
 			return Status::TRAP; //Nije bilo moguce apdejtovati PMT
 		}
 	}
@@ -68,9 +119,64 @@ Status KernelProcess::createSegment(VirtualAddress startAddress, PageNum segment
 }
 
 Status KernelProcess::loadSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags, void* content) {
-	
 
-	this->checkSegment(startAddress, segmentSize);
+	Status status = this->checkSegment(startAddress, segmentSize); //Klasteri se ne zauzimaju za segment koji ne moze da se kreira
+	if (status != Status::OK) return status;
+
+	//Sadrzaj segmenta se jednom upisuje na disk, u niz susednih klastera ako postoji. Stranice se ucitavaju pri prvom
+	//pristupu kao swapovane stranice, a stranica koja nije menjana se pri izbacivanju ne upisuje ponovo na disk.
+	std::vector<ClusterNo> clusters;
+
+	try {
+		ClusterNo first = KernelSystem::kernelSystem->getFreeClusterRun(segmentSize);
+
+		for (PageNum i = 0; i < segmentSize; i++) clusters.push_back(first + i);
+	}
+
+	catch (const MemoryException&) { //Nema dovoljno dugackog niza, klasteri se dodeljuju pojedinacno
+		try {
+			while (clusters.size() < segmentSize) clusters.push_back(KernelSystem::kernelSystem->getFreeCluster());
+		}
+
+		catch (const MemoryException&) { //Nema mesta na disku, sadrzaj se kopira u frejmove
+			for (ClusterNo cluster : clusters) KernelSystem::kernelSystem->setClusterFree(cluster);
+
+			return this->loadSegmentToFrames(startAddress, segmentSize, flags, content);
+		}
+	}
+
+	std::vector<std::pair<ClusterNo, const char*>> pages;
+	for (PageNum i = 0; i < segmentSize; i++) {
+		pages.push_back({ clusters[i], (const char*)content + i * PAGE_SIZE });
+	}
+
+	if (!KernelSystem::kernelSystem->writeClusterRuns(pages)) {
+		TRACE_ERROR(LOAD_SEGMENT_WRITE_FAILED, this->pid, startAddress);
+
+		for (ClusterNo cluster : clusters) KernelSystem::kernelSystem->setClusterFree(cluster);
+		return Status::TRAP;
+	}
+
+	for (PageNum i = 0; i < segmentSize; i++) {
+		VirtualAddress page = startAddress + i * PAGE_SIZE;
+
+		if (!this->updatePMT(page, nullptr, i, flags, false)) { //Postavljanje odgovarajuceg deskriptora u tabeli stranica
+			if (i > 0) this->deleteSegment(startAddress); //Brise vec postavljene deskriptore i oslobadja njihove klastere
+
+			for (PageNum j = i; j < segmentSize; j++) KernelSystem::kernelSystem->setClusterFree(clusters[j]);
+			return Status::TRAP; //Nije bilo moguce apdejtovanje PMTa.
+		}
+
+		Descriptor& desc = pmtHead->level2entry[(page >> PMT1_OFFSET) & PMT_ENTRY_MASK]->entry[(page >> PMT2_OFFSET) & PMT_ENTRY_MASK];
+
+		desc.disk = clusters[i];
+		desc.frameAndFlags |= SET_S;
+	}
+
+	return Status::OK;
+}
+
+Status KernelProcess::loadSegmentToFrames(VirtualAddress startAddress, PageNum segmentSize, AccessType flags, void* content) {
 
 	for (PageNum i = 0; i < segmentSize; i++) {
 
@@ -80,7 +186,7 @@ Status KernelProcess::loadSegment(VirtualAddress startAddress, PageNum segmentSi
 		}
 
 		catch (MemoryException e) { //Ako je bilo greske pri dohvatanju stranice, ispisuje se greska i vraca se TRAP.
-			std::cout << e;
+			TRACE_ERROR(LOAD_SEGMENT_NO_MEMORY, this->pid, startAddress);
 			return Status::TRAP;
 		}
 
@@ -103,57 +209,102 @@ Status KernelProcess::loadSegment(VirtualAddress startAddress, PageNum segmentSi
 Status KernelProcess::deleteSegment(VirtualAddress startAddress) {
 
 	if (startAddress & WORD_MASK) { //Provera da li je adresa poravnata na pocetak stranice
-		std::cout << "GRESKA: metoda deleteSegment | Pocetna adresa nije poravnata na pocetak segmenta.\n";
+		TRACE_ERROR(DELETE_SEGMENT_NOT_ALIGNED, this->pid, startAddress);
 		return Status::TRAP;
 	}
 
 	if (!this->checkAllocated(startAddress)) {
-		std::cout << "GRESKA: metoda deleteSegment | Prosledjena adresa nije pocetak segmenta..\n";
+		TRACE_ERROR(DELETE_SEGMENT_NOT_ALLOCATED, this->pid, startAddress);
 		return Status::TRAP;
 	}
 
-	PMT2* pmt2 = pmtHead->level2entry[(startAddress >> PMT1_OFFSET) & PMT_ENTRY_MASK];
-	
-	Descriptor* desc = &pmt2->entry[(startAddress >> PMT2_OFFSET) & PMT_ENTRY_MASK];
+	Descriptor* desc = this->getDescriptor(startAddress);
+
+	if (desc == nullptr) { //Adresa pripada velikoj stranici, koja moze biti prva stranica segmenta samo od svog pocetka
+		desc = this->getSuperpage(startAddress);
 
-	if (desc->ordinal != 0) {
-		std::cout << "GRESKA: metoda deleteSegment | Prosledjena adresa nije adresa prve stranice u segmentu.\n";
+		if (startAddress & (((VirtualAddress)1 << PMT1_OFFSET) - 1)) {
+			TRACE_ERROR(DELETE_SEGMENT_NOT_FIRST_PAGE, this->pid, startAddress);
+			return Status::TRAP;
+		}
+	}
+
+	if (!(desc->frameAndFlags & ST_MASK)) {
+		TRACE_ERROR(DELETE_SEGMENT_NOT_FIRST_PAGE, this->pid, startAddress);
 		return Status::TRAP;
 	}
 
-	if (desc->frameAndFlags & SH_MASK) {
-		std::cout << "GRESKA: metoda deleteSegment | Pokusaj brisanja deljenog segmenta.\n";
+	if ((desc->frameAndFlags & SH_MASK) && !(desc->frameAndFlags & COW_MASK)) {
+		TRACE_ERROR(DELETE_SEGMENT_SHARED, this->pid, startAddress);
 		return Status::TRAP;
 	}
 
 	bool first = true;
 	PageNum i = 0;
-	while ((desc->ordinal != 0 && (desc->frameAndFlags & L_MASK) && (pmt2 != nullptr)) || first) {
+	while (first || ((desc != nullptr) && !(desc->frameAndFlags & ST_MASK) && (desc->frameAndFlags & L_MASK))) {
 		if (first) {
 			first = false;
 		}
+
+		unsigned char entry1 = ((startAddress + i * PAGE_SIZE) >> PMT1_OFFSET) & PMT_ENTRY_MASK;
+		PMT2* pmt2 = pmtHead->level2entry[entry1];
+
+		if (pmt2 == nullptr) { //Velika stranica se brise cela, sa svim frejmovima i klasterima
+			{
+				DummyMutex dummy(KernelSystem::kernelSystem->evictionMutex);
+
+				unsigned int frameAndFlags = desc->frameAndFlags.exchange(0);
+
+				if (frameAndFlags & V_MASK) {
+					PhysicalAddress frameAddress = KernelSystem::kernelSystem->getFrameAddress(frameAndFlags & FRAME_MASK);
+
+					KernelSystem::kernelSystem->unmapFrame(frameAddress);
+					KernelSystem::kernelSystem->deallocatePages(frameAddress, SUPERPAGE_SIZE);
+				}
+
+				for (PageNum j = 0; (desc->disk != NO_CLUSTER) && (j < SUPERPAGE_SIZE); j++) {
+					KernelSystem::kernelSystem->setClusterFree(desc->disk + j);
+				}
+			}
+
+			--pmtHead->entriesUsed;
+
+			i += SUPERPAGE_SIZE;
+			desc = this->getDescriptor(startAddress + i * PAGE_SIZE);
+			if (desc == nullptr) desc = this->getSuperpage(startAddress + i * PAGE_SIZE);
+			continue;
+		}
 	
-		PhysicalAddress frameAddress = (PhysicalAddress)((desc->frameAndFlags & FRAME_MASK) << ADR_WORD);
+		{
+			DummyMutex dummy(KernelSystem::kernelSystem->evictionMutex); //Stranica ne sme biti izbacena dok se oslobadja njen frejm
 
-		KernelSystem::kernelSystem->deallocatePage(frameAddress); //Dealociranje jedne stranice
+			unsigned int frameAndFlags = desc->frameAndFlags.exchange(0);
 
-		desc->frameAndFlags = 0;
+			if (frameAndFlags & V_MASK) { //Frejm se oslobadja samo ako je stranica u memoriji, u suprotnom ga vec koristi neka druga stranica
+				PhysicalAddress frameAddress = KernelSystem::kernelSystem->getFrameAddress(frameAndFlags & FRAME_MASK);
 
-		if (desc->frameAndFlags & S_MASK) { //Ako je bio swapowan, postavlja se da je klaster slobodan
-			KernelSystem::kernelSystem->setClusterFree(desc->disk);
+				KernelSystem::kernelSystem->unmapFrame(frameAddress);
+				KernelSystem::kernelSystem->deallocatePage(frameAddress); //Dealociranje jedne stranice
+			}
+
+			if (!(frameAndFlags & SH_MASK) && (desc->disk != NO_CLUSTER)) { //Oslobadja se klaster dodeljen stranici, i ako na njega jos nije upisana
+				KernelSystem::kernelSystem->setClusterFree(desc->disk);
+			}
+
+			if (frameAndFlags & COW_MASK) { //Frejm i klaster stranice koja se deli sa klonom se oslobadjaju posle poslednje reference
+				KernelSystem::kernelSystem->releaseCowPage(KernelSystem::kernelSystem->getSharedDescriptor(desc));
+			}
 		}
 
-		if (--pmt2->entriesUsed == 0) { //Brisanje tabele drugog nivoa ako se vise ne koristi ni jedan ulaz
+		if (--pmtHead->level2EntriesUsed[entry1] == 0) { //Brisanje tabele drugog nivoa ako se vise ne koristi ni jedan ulaz
 			KernelSystem::kernelSystem->deallocatePMT(pmt2, PMTType::LEVEL2_PMT);
-			pmtHead->level2entry[((startAddress + i * PAGE_SIZE) >> PMT1_OFFSET) & PMT_ENTRY_MASK] = nullptr;
+			pmtHead->level2entry[entry1] = nullptr;
 			--pmtHead->entriesUsed;
 		}
 
 		++i;
-		pmt2 = pmtHead->level2entry[((startAddress + i * PAGE_SIZE)>> PMT1_OFFSET) & PMT_ENTRY_MASK]; 
-		if (pmt2 != nullptr) {
-			desc = &pmt2->entry[((startAddress + i * PAGE_SIZE) >> PMT2_OFFSET) & PMT_ENTRY_MASK];
-		}
+		desc = this->getDescriptor(startAddress + i * PAGE_SIZE);
+		if (desc == nullptr) desc = this->getSuperpage(startAddress + i * PAGE_SIZE);
 	}
 
 	if (pmtHead->entriesUsed == 0) {
@@ -165,7 +316,7 @@ Status KernelProcess::deleteSegment(VirtualAddress startAddress) {
 
 Status KernelProcess::deleteSegmentLock(VirtualAddress startAddress)
 {
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
+	DummyMutex dummy(this->pmtMutex);
 	return this->deleteSegment(startAddress);
 }
 
@@ -173,28 +324,57 @@ Status KernelProcess::pageFault(VirtualAddress address) {
 	
 
 	if (this->pmtHead == nullptr) {  //Nije alocirana ni jedna stranica
-		std::cout << "Metoda pageFault | Trazena stranica nije bila ucitana metodom create ili load segment.\n";
+		TRACE_INFO(PAGE_FAULT_NOT_LOADED, this->pid, address);
 		return Status::TRAP;
 	}
 
 	PMT2* pmt2;
 	if ((pmt2 = pmtHead->level2entry[(address >> PMT1_OFFSET) & PMT_ENTRY_MASK]) == nullptr) { //U potrebnom ulazu nije alocirana tabela drugog nivoa
-		std::cout << "Metoda pageFault | Trazena stranica nije bila ucitana metodom create ili load segment.\n";
+		if (this->getSuperpage(address) != nullptr) {
+			return this->superpageFault(address);
+		}
+
+		TRACE_INFO(PAGE_FAULT_NOT_LOADED, this->pid, address);
 		return Status::TRAP;
 	}
 
-	Descriptor& desc = pmt2->entry[(address >> PMT2_OFFSET) & PMT_ENTRY_MASK];
-	if (!(desc.frameAndFlags & L_MASK)) { //Nije ucitana stranica
-		std::cout << "Metoda pageFault | Trazena stranica nije bila ucitana metodom create ili load segment.\n";
+	Descriptor* desc = &pmt2->entry[(address >> PMT2_OFFSET) & PMT_ENTRY_MASK];
+	if (!(desc->frameAndFlags & L_MASK)) { //Nije ucitana stranica
+		TRACE_INFO(PAGE_FAULT_NOT_LOADED, this->pid, address);
 		return Status::TRAP;
 	}
 
-	if (desc.frameAndFlags & SH_MASK) {
-		desc = *desc.sharedDesc;
+	bool shared = (desc->frameAndFlags & SH_MASK) != 0;
+
+	if (desc->frameAndFlags & COW_MASK) {
+		Descriptor* cowDesc = KernelSystem::kernelSystem->getSharedDescriptor(desc);
+
+		//Access vraca PAGE_FAULT za stranicu u memoriji samo pri upisu, a izbacena stranica se prvo ucitava kao deljena
+		if (cowDesc->frameAndFlags & V_MASK) {
+			return this->copyOnWrite(address, desc);
+		}
 	}
 
-	if (desc.frameAndFlags & V_MASK) { //Stranica je vec ucitana
-		return Status::OK;
+	if (shared) {
+		desc = KernelSystem::kernelSystem->getSharedDescriptor(desc);
+	}
+
+	//Stranicu deljenog segmenta moze istovremeno da trazi vise procesa, ucitava je samo proces koji postavi LD bit,
+	//a ostali cekaju da V bit bude postavljen
+	unsigned int frameAndFlags = desc->frameAndFlags;
+
+	while (true) {
+		if (frameAndFlags & V_MASK) { //Stranica je vec ucitana
+			return Status::OK;
+		}
+
+		if (frameAndFlags & LD_MASK) {
+			std::this_thread::yield();
+			frameAndFlags = desc->frameAndFlags;
+			continue;
+		}
+
+		if (desc->frameAndFlags.compare_exchange_weak(frameAndFlags, frameAndFlags | SET_LD)) break;
 	}
 
 	PhysicalAddress addr = nullptr;
@@ -203,67 +383,512 @@ Status KernelProcess::pageFault(VirtualAddress address) {
 	}
 
 	catch (MemoryException e) { //Ovaj exception se desava ako nema slobodnog prostora na klasteru ili je doslo do greske prilikom swapovanja stranice na particiju
-		std::cout << e;
+		desc->frameAndFlags &= RESET_LD;
+		TRACE_ERROR(PAGE_FAULT_NO_MEMORY, this->pid, address);
 		return Status::TRAP;
 	}
 
+	KernelSystem* system = KernelSystem::kernelSystem;
+
+	VirtualAddress page = address & ~(VirtualAddress)WORD_MASK;
+
+	std::vector<std::pair<VirtualAddress, PhysicalAddress>> around; //Susedne stranice koje se ucitavaju unapred, sortirane po klasterima
+	PageNum before = 0; //Broj susednih stranica ispred trazene
+
+	ClusterNo cluster;
+	{
+		//Izbacivanje brise V bit pre upisa stranice na disk, pa se ceka da se zavrsi izbacivanje koje je u toku
+		DummyMutex dummy(system->evictionMutex);
+
+		frameAndFlags = desc->frameAndFlags;
+		cluster = desc->disk;
+
+		if (!shared && ((frameAndFlags & (V_MASK | S_MASK)) == S_MASK)) {
+			before = this->claimFaultAround(page, cluster, around);
+		}
+	}
+
+	if (frameAndFlags & V_MASK) { //Izbacivanje je vratilo stranicu jer nije bilo slobodnog klastera
+		desc->frameAndFlags &= RESET_LD;
+		system->deallocatePage(addr);
+		return Status::OK;
+	}
+
 	//Stranica moze biti kreirana ali bez ikakvog upisa, tada se stranica ne swapuje na disk
-	//ukoliko je bilo upisa, svapovace se. Ako nije svapovana, samo ce se ucitati nova stranica
-	//i dodeliti procesu.
-	if (desc.frameAndFlags & S_MASK) {
+	//ukoliko je bilo upisa, svapovace se. Ako nije svapovana, procesu se dodeljuje stranica
+	//ispunjena nulama.
+	if (frameAndFlags & S_MASK) {
 		char *buffer = (char*)addr;
-#ifdef PRINT
-		std::cout << "Metoda PageFault | Citanje stranice sa diska.\n";
-#endif
-		if (!KernelSystem::kernelSystem->partition->readCluster(desc.disk, buffer)) {
+		TRACE_DEBUG(PAGE_FAULT_DISK_READ, this->pid, address, cluster);
+		bool read;
+
+		if (around.empty()) {
+			read = system->readClusters(cluster, 1, &buffer);
+		}
+		else { //Trazena i susedne stranice se citaju jednim pozivom
+			std::vector<char*> buffers;
+			for (auto& neighbour : around) buffers.push_back((char*)neighbour.second);
+			buffers.insert(buffers.begin() + before, buffer);
+
+			read = system->readClusters(cluster - before, buffers.size(), buffers.data());
+		}
+
+		if (!read) {
+			for (auto& neighbour : around) {
+				this->getDescriptor(neighbour.first)->frameAndFlags &= RESET_LD;
+				system->deallocatePage(neighbour.second);
+			}
+
+			desc->frameAndFlags &= RESET_LD;
+			system->deallocatePage(addr);
 			return Status::TRAP;
 		}
 	}
+	else {
+		system->clearContent((char*)addr);
+	}
+
+	frameAndFlags &= FRAME_MASK_DELETE & RESET_D & RESET_LD;
+	frameAndFlags |= system->getFrameIndex(addr); //Upisivanje novog broja frejma
+	frameAndFlags |= SET_V | SET_F; //Setovanje V bita, prvi sledeci pristup je ponovljeni pristup koji je izazvao page fault
+
+	{
+		DummyMutex dummy(system->evictionMutex);
+
+		desc->frameAndFlags = frameAndFlags;
 
-	desc.frameAndFlags &= FRAME_MASK_DELETE;
-	desc.frameAndFlags |= (((unsigned int)addr) >> ADR_WORD) & FRAME_MASK; //Upisivanje novog broja frejma
+		system->mapFrame(addr, desc, this->pid, page, shared); //Upis vlasnika frejma u invertovanu tabelu
 
-	desc.frameAndFlags |= SET_V; //Setovanje V bita
-	desc.frameAndFlags &= RESET_D; //Resetovanje D bita
+		//Susedne stranice se ne prijavljuju kao referencirane, pa ih algoritam zamene prvo izbacuje ako im se ne pristupi
+		for (auto& neighbour : around) {
+			Descriptor* neighbourDesc = this->getDescriptor(neighbour.first);
+
+			neighbourDesc->frameAndFlags = (neighbourDesc->frameAndFlags & FRAME_MASK_DELETE & RESET_D & RESET_LD) | system->getFrameIndex(neighbour.second) | SET_V;
+
+			system->mapFrame(neighbour.second, neighbourDesc, this->pid, neighbour.first, false, true);
+		}
+	}
 	
-#ifdef PRINT
-	std::cout << "Metoda PageFault | Vracena stranica sa diska | Virtuelna adresa = " << address << "\n";
-#endif
+	TRACE_DEBUG(PAGE_FAULT_LOADED, this->pid, address, system->getFrameIndex(addr));
+	return Status::OK;
+}
+
+void KernelProcess::pageFaults(const std::vector<VirtualAddress>& addresses) {
+	KernelSystem* system = KernelSystem::kernelSystem;
+
+	std::vector<std::pair<ClusterNo, VirtualAddress>> pages; //Stranice sortirane po klasterima, stranice bez sadrzaja na disku su na kraju
+
+	for (VirtualAddress address : addresses) {
+		Descriptor* desc = this->getDescriptor(address);
+		bool superpage = false;
+
+		if (desc == nullptr) {
+			desc = this->getSuperpage(address);
+			superpage = true;
+		}
+
+		ClusterNo cluster = NO_CLUSTER;
+
+		if (desc != nullptr) {
+			if (desc->frameAndFlags & SH_MASK) desc = system->getSharedDescriptor(desc);
+
+			if (desc->frameAndFlags & S_MASK) cluster = desc->disk + (superpage ? (address >> PMT2_OFFSET) & PMT_ENTRY_MASK : 0);
+		}
+
+		pages.push_back({ cluster, address & ~(VirtualAddress)WORD_MASK });
+	}
+
+	std::sort(pages.begin(), pages.end());
+
+	for (PageNum i = 0; i < pages.size(); i++) {
+		if ((i > 0) && (pages[i].second == pages[i - 1].second)) continue;
+
+		this->pageFault(pages[i].second);
+	}
+}
+
+void KernelProcess::countPages(PageNum& resident, PageNum& swapped) {
+	resident = swapped = 0;
+
+	if (this->pmtHead == nullptr) return;
+
+	KernelSystem* system = KernelSystem::kernelSystem;
+
+	for (PageNum i = 0; i < PMT1_SIZE; i++) {
+		PMT2* pmt2 = this->pmtHead->level2entry[i];
+
+		if (pmt2 == nullptr) { //Velika stranica je cela u memoriji ili cela na disku
+			unsigned int frameAndFlags = this->pmtHead->superpage[i].frameAndFlags;
+
+			if (!(frameAndFlags & L_MASK)) continue;
+
+			if (frameAndFlags & V_MASK) resident += SUPERPAGE_SIZE;
+			else if (frameAndFlags & S_MASK) swapped += SUPERPAGE_SIZE;
+
+			continue;
+		}
+
+		for (PageNum j = 0; j < PMT2_SIZE; j++) {
+			Descriptor* desc = &pmt2->entry[j];
+
+			if (!(desc->frameAndFlags & L_MASK)) continue;
+
+			if (desc->frameAndFlags & SH_MASK) desc = system->getSharedDescriptor(desc);
+
+			unsigned int frameAndFlags = desc->frameAndFlags;
+
+			if (frameAndFlags & V_MASK) ++resident;
+			else if (frameAndFlags & S_MASK) ++swapped;
+		}
+	}
+}
+
+PageNum KernelProcess::claimFaultAround(VirtualAddress page, ClusterNo cluster, std::vector<std::pair<VirtualAddress, PhysicalAddress>>& around) {
+	KernelSystem* system = KernelSystem::kernelSystem;
+
+	PageNum limit = system->config.faultAroundPages;
+
+	//Stranice iza trazene, pa stranice ispred nje. Susedna stranica se ucitava ako pripada istom segmentu, izbacena je
+	//na klaster koji nastavlja niz klastera i ima slobodan frejm. Prva stranica koja ne ispunjava uslove prekida niz.
+	PageNum after = 0, before = 0;
+
+	Descriptor* pageDesc = this->getDescriptor(page);
+
+	for (int direction = 1; direction >= -1; direction -= 2) {
+		VirtualAddress current = page;
+
+		//Proces prolazi kroz segment u smeru direction samo ako je stranica sa druge strane trazene u memoriji,
+		//inace je pristup nasumican i stranice ucitane unapred bi bile izbacene bez koriscenja
+		Descriptor* previousDesc = this->getDescriptor(page - direction * PAGE_SIZE);
+
+		if (previousDesc == nullptr) continue;
+		if ((direction > 0 ? pageDesc : previousDesc)->frameAndFlags & ST_MASK) continue; //Stranice nisu u istom segmentu
+		if ((previousDesc->frameAndFlags & (L_MASK | SH_MASK | V_MASK)) != (L_MASK | V_MASK)) continue;
+
+		while (after + before < limit) {
+			Descriptor* currentDesc = this->getDescriptor(current);
+
+			if (direction < 0 && (currentDesc->frameAndFlags & ST_MASK)) break; //Trazena stranica je prva u segmentu
+
+			VirtualAddress next = current + direction * PAGE_SIZE;
+			Descriptor* nextDesc = this->getDescriptor(next);
+
+			if (nextDesc == nullptr) break;
+
+			unsigned int flags = nextDesc->frameAndFlags;
+
+			if ((flags & (L_MASK | SH_MASK | V_MASK | S_MASK | LD_MASK)) != (L_MASK | S_MASK)) break; //Stranica nije izbacena ili je deljena
+
+			if (direction > 0 && (flags & ST_MASK)) break; //Pocetak sledeceg segmenta
+
+			PageNum distance = (direction > 0) ? after + 1 : before + 1;
+			if (direction < 0 && cluster < distance) break;
+
+			ClusterNo expected = (direction > 0) ? cluster + distance : cluster - distance;
+			if (nextDesc->disk != expected) break;
+
+			if (!nextDesc->frameAndFlags.compare_exchange_strong(flags, flags | SET_LD)) break; //Pristup stranici ne menja flegove dok V bit nije postavljen
+
+			PhysicalAddress frame = system->allocateFreePage();
+			if (frame == nullptr) {
+				nextDesc->frameAndFlags &= RESET_LD;
+				return before;
+			}
+
+			if (direction > 0) {
+				around.push_back({ next, frame });
+				++after;
+			}
+			else {
+				around.insert(around.begin(), { next, frame });
+				++before;
+			}
+
+			current = next;
+		}
+	}
+
+	return before;
+}
+
+Descriptor* KernelProcess::getDescriptor(VirtualAddress page) {
+	if (((page >> PMT1_OFFSET) >= PMT1_SIZE) || (this->pmtHead == nullptr)) return nullptr;
+
+	PMT2* pmt2 = this->pmtHead->level2entry[(page >> PMT1_OFFSET) & PMT_ENTRY_MASK];
+
+	if (pmt2 == nullptr) return nullptr;
+
+	return &pmt2->entry[(page >> PMT2_OFFSET) & PMT_ENTRY_MASK];
+}
+
+Descriptor* KernelProcess::getSuperpage(VirtualAddress page) {
+	if (((page >> PMT1_OFFSET) >= PMT1_SIZE) || (this->pmtHead == nullptr)) return nullptr;
+
+	unsigned char entry1 = (page >> PMT1_OFFSET) & PMT_ENTRY_MASK;
+
+	if ((this->pmtHead->level2entry[entry1] != nullptr) || !(this->pmtHead->superpage[entry1].frameAndFlags & L_MASK)) return nullptr;
+
+	return &this->pmtHead->superpage[entry1];
+}
+
+bool KernelProcess::allocatePMT1() {
+	if (this->pmtHead != nullptr) return true;
+
+	PhysicalAddress adr = KernelSystem::kernelSystem->allocatePMT(PMTType::LEVEL1_PMT);
+
+	if (adr == nullptr) { //Ako metoda allocatePmt vrati nullptr znaci da nema dovoljno prostora za PMT
+		TRACE_ERROR(PMT1_NO_SPACE, this->pid);
+		return false;
+	}
+
+	PMT1* pmt1 = (PMT1*)adr;
+
+	//Inicijalizacija PM tabele prvog nivoa
+	for (int i = 0; i < PMT1_SIZE; i++) {
+		pmt1->level2entry[i] = nullptr;
+		pmt1->level2EntriesUsed[i] = 0;
+		pmt1->superpage[i].frameAndFlags = 0;
+	}
+
+	pmt1->entriesUsed = 0;
+
+	this->pmtHead = pmt1;
+
+	return true;
+}
+
+bool KernelProcess::createSuperpage(VirtualAddress page, PageNum ordinal, AccessType flags, PhysicalAddress frame) {
+	KernelSystem* system = KernelSystem::kernelSystem;
+
+	if (!this->allocatePMT1()) return false;
+
+	unsigned char entry1 = (page >> PMT1_OFFSET) & PMT_ENTRY_MASK;
+
+	if ((this->pmtHead->level2entry[entry1] != nullptr) || (this->pmtHead->superpage[entry1].frameAndFlags & L_MASK)) {
+		TRACE_ERROR(SUPERPAGE_ALLOCATED, this->pid, page);
+		return false;
+	}
+
+	Descriptor& desc = this->pmtHead->superpage[entry1];
+
+	unsigned int frameAndFlags = SET_L | ((unsigned int)flags << ACCESS_BITS_SHIFT);
+	frameAndFlags |= (ordinal == 0) ? SET_ST : 0; //Postavljanje bita pocetka segmenta
+
+	desc.disk = NO_CLUSTER; //Niz klastera se dodeljuje pri prvom izbacivanju velike stranice
+
+	++this->pmtHead->entriesUsed;
+
+	if (frame == nullptr) {
+		desc.frameAndFlags = frameAndFlags;
+		return true;
+	}
+
+	DummyMutex dummy(system->evictionMutex);
+
+	desc.frameAndFlags = frameAndFlags | SET_V | system->getFrameIndex(frame);
+
+	system->mapFrame(frame, &desc, this->pid, page, false, false, true);
+
+	return true;
+}
+
+Status KernelProcess::superpageFault(VirtualAddress address) {
+	KernelSystem* system = KernelSystem::kernelSystem;
+
+	Descriptor* desc = this->getSuperpage(address);
+	VirtualAddress page = address & ~(((VirtualAddress)1 << PMT1_OFFSET) - 1);
+
+	if (desc->frameAndFlags & V_MASK) return Status::OK;
+
+	PhysicalAddress addr = system->allocateAlignedRun(SUPERPAGE_SIZE);
+
+	if (addr == nullptr) { //Nema slobodnog poravnatog niza frejmova, velika stranica se deli na obicne stranice
+		if (!this->splitSuperpage(page)) return Status::TRAP;
+
+		return this->pageFault(address);
+	}
+
+	unsigned int frameAndFlags;
+	ClusterNo cluster;
+	{
+		DummyMutex dummy(system->evictionMutex);
+
+		frameAndFlags = desc->frameAndFlags;
+		cluster = desc->disk;
+	}
+
+	if (frameAndFlags & S_MASK) {
+		char* buffers[SUPERPAGE_SIZE];
+		for (PageNum i = 0; i < SUPERPAGE_SIZE; i++) buffers[i] = (char*)addr + i * PAGE_SIZE;
+
+		if (!system->readClusters(cluster, SUPERPAGE_SIZE, buffers)) {
+			system->deallocatePages(addr, SUPERPAGE_SIZE);
+			return Status::TRAP;
+		}
+	}
+	else {
+		for (PageNum i = 0; i < SUPERPAGE_SIZE; i++) system->clearContent((char*)addr + i * PAGE_SIZE);
+	}
+
+	frameAndFlags &= FRAME_MASK_DELETE & RESET_D;
+	frameAndFlags |= system->getFrameIndex(addr) | SET_V | SET_F;
+
+	{
+		DummyMutex dummy(system->evictionMutex);
+
+		desc->frameAndFlags = frameAndFlags;
+
+		system->mapFrame(addr, desc, this->pid, page, false, false, true);
+	}
+
+	return Status::OK;
+}
+
+bool KernelProcess::splitSuperpage(VirtualAddress page) {
+	KernelSystem* system = KernelSystem::kernelSystem;
+
+	unsigned char entry1 = (page >> PMT1_OFFSET) & PMT_ENTRY_MASK;
+
+	PMT2* pmt2 = (PMT2*)system->allocatePMT(PMTType::LEVEL2_PMT);
+
+	if (pmt2 == nullptr) {
+		TRACE_ERROR(SPLIT_SUPERPAGE_NO_SPACE, this->pid, page);
+		return false;
+	}
+
+	DummyMutex dummy(system->evictionMutex);
+
+	Descriptor& desc = this->pmtHead->superpage[entry1];
+
+	unsigned int frameAndFlags = desc.frameAndFlags;
+	ClusterNo cluster = desc.disk;
+	PageNum head = frameAndFlags & FRAME_MASK;
+
+	//Svaka stranica nasledjuje prava pristupa i stanje velike stranice, a dobija svoj frejm i klaster iz niza
+	for (PageNum i = 0; i < PMT2_SIZE; i++) {
+		pmt2->entry[i].disk = (cluster != NO_CLUSTER) ? cluster + i : NO_CLUSTER;
+		pmt2->entry[i].frameAndFlags = (frameAndFlags & (ACCESS_BITS_MASK | L_MASK | V_MASK | D_MASK | S_MASK))
+			| ((i == 0) ? (frameAndFlags & ST_MASK) : 0) | ((frameAndFlags & V_MASK) ? head + i : 0);
+	}
+
+	this->pmtHead->level2EntriesUsed[entry1] = PMT2_SIZE;
+	this->pmtHead->level2entry[entry1] = pmt2;
+
+	//Pogodak u access-u mogao je u medjuvremenu da postavi D bit velike stranice
+	frameAndFlags = desc.frameAndFlags.exchange(0);
+
+	if (frameAndFlags & V_MASK) {
+		system->unmapFrame(system->getFrameAddress(head));
+
+		for (PageNum i = 0; i < PMT2_SIZE; i++) {
+			pmt2->entry[i].frameAndFlags |= frameAndFlags & D_MASK;
+
+			system->mapFrame(system->getFrameAddress(head + i), &pmt2->entry[i], this->pid, page + i * PAGE_SIZE);
+		}
+	}
+
+	return true;
+}
+
+Status KernelProcess::copyOnWrite(VirtualAddress address, Descriptor* desc) {
+	KernelSystem* system = KernelSystem::kernelSystem;
+	Descriptor* cowDesc = system->getSharedDescriptor(desc);
+	VirtualAddress page = address & ~(VirtualAddress)WORD_MASK;
+
+	{
+		DummyMutex dummy(system->evictionMutex);
+
+		if (((CowDescriptor*)cowDesc)->refCount == 1) { //Ostali procesi su vec kopirali ili obrisali stranicu, pa je proces preuzima bez kopiranja
+			unsigned int cowFlags = cowDesc->frameAndFlags.exchange(0);
+
+			//Access cita sharedIndex samo dok je SH bit postavljen, pa se broj klastera upisuje posle flegova
+			desc->frameAndFlags = (desc->frameAndFlags & (ACCESS_BITS_MASK | L_MASK | ST_MASK)) | (cowFlags & (FRAME_MASK | V_MASK | D_MASK | S_MASK | F_MASK | LD_MASK));
+			desc->disk = cowDesc->disk;
+
+			if (cowFlags & V_MASK) {
+				system->setFrameOwner(cowFlags & FRAME_MASK, desc, this->pid, page, false);
+			}
+
+			system->deallocatePMT(cowDesc, PMTType::COW_DESCRIPTOR);
+			return Status::OK;
+		}
+	}
+
+	PhysicalAddress addr = nullptr;
+	try {
+		addr = system->allocatePage();
+	}
+
+	catch (const MemoryException&) {
+		TRACE_ERROR(COPY_ON_WRITE_NO_MEMORY, this->pid, address);
+		return Status::TRAP;
+	}
+
+	system->readPage(cowDesc, (char*)addr);
+
+	DummyMutex dummy(system->evictionMutex);
+
+	//Klaster ostaje zajednickoj stranici, a kopija dobija svoj pri prvom upisu na disk
+	unsigned int frameAndFlags = desc->frameAndFlags & (ACCESS_BITS_MASK | L_MASK | ST_MASK);
+	frameAndFlags |= system->getFrameIndex(addr);
+	frameAndFlags |= SET_V | SET_D | SET_F; //Kopija jos nije upisana na disk
+
+	desc->frameAndFlags = frameAndFlags;
+	desc->disk = NO_CLUSTER; //Posle brisanja SH bita, kao i kod preuzimanja stranice
+
+	system->mapFrame(addr, desc, this->pid, page);
+
+	system->releaseCowPage(cowDesc);
+
 	return Status::OK;
 }
 
 PhysicalAddress KernelProcess::getPhysicalAddress(VirtualAddress address) {
+	PageNum frame;
+
 	if (this->pmtHead == nullptr) {  //Nije alocirana ni jedna stranica
-		std::cout << "Metoda GetPhysicalAddress | Nedozvoljeno preslikavanje\n";
+		TRACE_ERROR(PHYSICAL_ADDRESS_UNMAPPED, this->pid, address);
 		std::exit(1);
 	}
 
 	PMT2* pmt2;
+	Descriptor* desc;
+	bool superpage = false;
+
 	if ((pmt2 = pmtHead->level2entry[(address >> PMT1_OFFSET) & PMT_ENTRY_MASK]) == nullptr) { //U potrebnom ulazu nije alocirana tabela drugog nivoa
-		std::cout << "Metoda GetPhysicalAddress | Nedozvoljeno preslikavanje\n";
-		std::exit(1);
+		if ((desc = this->getSuperpage(address)) == nullptr) {
+			TRACE_ERROR(PHYSICAL_ADDRESS_UNMAPPED, this->pid, address);
+			std::exit(1);
+		}
+
+		superpage = true;
 	}
-	
-	Descriptor& desc = pmt2->entry[(address >> PMT2_OFFSET) & PMT_ENTRY_MASK];
-	if (!(desc.frameAndFlags & L_MASK)) { //Nije ucitana stranica
-		std::cout << "Metoda GetPhysicalAddress | Nedozvoljeno preslikavanje\n";
+	else {
+		desc = &pmt2->entry[(address >> PMT2_OFFSET) & PMT_ENTRY_MASK];
+	}
+
+	if (!(desc->frameAndFlags & L_MASK)) { //Nije ucitana stranica
+		TRACE_ERROR(PHYSICAL_ADDRESS_UNMAPPED, this->pid, address);
 		std::exit(1);
 	}
 
-	if (desc.frameAndFlags & SH_MASK) {
-		desc = *desc.sharedDesc;
+	if (desc->frameAndFlags & SH_MASK) {
+		desc = KernelSystem::kernelSystem->getSharedDescriptor(desc);
 	}
 
-	if (!(desc.frameAndFlags & V_MASK)) { //Stranica je bila ucitana ali je swapovana, generise se page fault da bi se prvo dovukla
+	if (!(desc->frameAndFlags & V_MASK)) { //Stranica je bila ucitana ali je swapovana, generise se page fault da bi se prvo dovukla
 		this->myProcess->pageFault(address);
+
+		if (superpage && (pmtHead->level2entry[(address >> PMT1_OFFSET) & PMT_ENTRY_MASK] != nullptr)) { //Page fault je podelio veliku stranicu
+			return this->getPhysicalAddress(address);
+		}
 	}
 
-	unsigned int intAddr = (desc.frameAndFlags & FRAME_MASK) << ADR_WORD;
-	intAddr |= address & WORD_MASK;
+	unsigned int frameAndFlags = desc->frameAndFlags;
 
-	PhysicalAddress addr = (PhysicalAddress)intAddr;
+	frame = (frameAndFlags & FRAME_MASK) + (superpage ? (address >> PMT2_OFFSET) & PMT_ENTRY_MASK : 0);
 
-	return addr;
+	return (char*)KernelSystem::kernelSystem->processVMSpace + frame * PAGE_SIZE + (address & WORD_MASK);
 }
 
 
@@ -296,16 +921,22 @@ Status KernelProcess::createSharedSegment(VirtualAddress startAddress, PageNum s
 			}
 
 			catch (MemoryException e) { //Ako je bilo greske pri dohvatanju stranice, ispisuje se greska i vraca se TRAP.
-				std::cout << e;
+				TRACE_ERROR(SHARED_SEGMENT_NO_MEMORY, this->pid, startAddress);
 				return Status::TRAP;
 			}
 
-			shared->pmt.entry[i].disk = 0;
-			shared->pmt.entry[i].ordinal = i;
+			shared->pmt.entry[i].disk = NO_CLUSTER;
 			shared->pmt.entry[i].frameAndFlags = 0;
 			shared->pmt.entry[i].frameAndFlags |= (SET_V | SET_L); //Postavljanje valid i loaded bita
+			shared->pmt.entry[i].frameAndFlags |= (i == 0) ? SET_ST : 0; //Postavljanje bita pocetka segmenta
 			shared->pmt.entry[i].frameAndFlags |= (unsigned int)flags << ACCESS_BITS_SHIFT; //Postavljanje prava pristupa
-			shared->pmt.entry[i].frameAndFlags |= (unsigned int)frameAddr >> ADR_WORD; //Postavljanje broja frejma u RAM memoriji
+			shared->pmt.entry[i].frameAndFlags |= KernelSystem::kernelSystem->getFrameIndex(frameAddr); //Postavljanje broja frejma u RAM memoriji
+
+			{
+				DummyMutex dummy(KernelSystem::kernelSystem->evictionMutex);
+
+				KernelSystem::kernelSystem->mapFrame(frameAddr, &shared->pmt.entry[i], this->pid, startAddress + i * PAGE_SIZE, true);
+			}
 
 			if (!this->updatePMT(startAddress + i * PAGE_SIZE, frameAddr, i, flags, false, true, &shared->pmt.entry[i])) { //Postavljanje odgovarajuceg deskriptora u tabeli stranica
 				return Status::TRAP; //Nije bilo moguce apdejtovati PMT
@@ -323,12 +954,12 @@ Status KernelProcess::createSharedSegment(VirtualAddress startAddress, PageNum s
 		SharedSegment* shared = seg->second;
 
 		if (shared->getSegmentSize() != segmentSize) {
-			std::cout << "Greska: Metoda createSharedSegment | Pokusaj da se doda vec kreiran segment u memorijski prostor, velicine segmenata nekompatibilne.\n";
+			TRACE_ERROR(SHARED_SEGMENT_SIZE_MISMATCH, this->pid, startAddress, segmentSize);
 			return Status::TRAP;
 		}
 
 		if (!((shared->getAccess() == flags) || ((shared->getAccess() == AccessType::READ_WRITE) && (shared->getAccess() > flags)))) { //Provera da li proces zeli da koristi segment sa pravima koja nisu u skladu sa onima vec dodeljenim segmentu
-			std::cout << "Greska: Metoda createSharedSegment | Pokusaj da se doda vec kreiran segment u memorijski prostor, prava pristupa nekompatibilna.\n";
+			TRACE_ERROR(SHARED_SEGMENT_RIGHTS_MISMATCH, this->pid, startAddress, flags);
 			return Status::TRAP;
 		}
 		else {
@@ -336,8 +967,7 @@ Status KernelProcess::createSharedSegment(VirtualAddress startAddress, PageNum s
 			int i = 0;
 
 			for (PageNum i = 0; i < shared->getSegmentSize(); i++) {
-				unsigned int intAddr = (shared->pmt.entry[i].frameAndFlags & FRAME_MASK) << ADR_WORD;
-				PhysicalAddress frameAddr = (PhysicalAddress)intAddr;
+				PhysicalAddress frameAddr = KernelSystem::kernelSystem->getFrameAddress(shared->pmt.entry[i].frameAndFlags & FRAME_MASK);
 
 				if (!this->updatePMT(startAddress + i * PAGE_SIZE, frameAddr, i, flags, false, true, &(shared->pmt.entry[i]))) {
 					return Status::TRAP; //Nije bilo moguce apdejtovati PMT
@@ -354,19 +984,20 @@ Status KernelProcess::createSharedSegment(VirtualAddress startAddress, PageNum s
 
 Status KernelProcess::disconnectSharedSegmentLock(const char * name)
 {
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
+	DummyMutex sharedDummy(KernelSystem::kernelSystem->sharedSegmentMutex);
+	DummyMutex dummy(this->pmtMutex);
 
 	return this->disconnectSharedSegment(name);
 }
 
 Status KernelProcess::disconnectSharedSegment(const char * name) {
 
-	auto segments = KernelSystem::kernelSystem->sharedSegments; //Mapa svih deljenih segmenata
+	auto& segments = KernelSystem::kernelSystem->sharedSegments; //Mapa svih deljenih segmenata
 
 	auto segmentPtr = segments.find(name); //Segment koji se trazi
 
 	if (segmentPtr == segments.end()) {
-		std::cout << "GRESKA: metoda disconnectSharedSegment | Deljeni segment sa zadatim imenom ne postoji.\n";
+		TRACE_ERROR(DISCONNECT_NO_SEGMENT, this->pid);
 		return Status::TRAP;
 	}
 	auto segment = segmentPtr->second;
@@ -374,7 +1005,7 @@ Status KernelProcess::disconnectSharedSegment(const char * name) {
 	auto startAddressPtr = segment->processes.find(this->pid);
 
 	if (startAddressPtr == segment->processes.end()) {
-		std::cout << "GRESKA: metoda disconnectSharedSegment | Proces ne koristi segment sa zadatim imenom.\n";
+		TRACE_ERROR(DISCONNECT_NOT_CONNECTED, this->pid);
 		return Status::TRAP;
 	}
 
@@ -383,16 +1014,18 @@ Status KernelProcess::disconnectSharedSegment(const char * name) {
 
 	for (PageNum i = 0; i < size; i++) {
 		if (!this->checkAllocated(startAddress + i * PAGE_SIZE)) {
-			std::cout << "GRESKA: metoda disconnectSharedSegment | Greska u PM tabeli procesa.\n";
+			TRACE_ERROR(DISCONNECT_PMT_ERROR, this->pid, startAddress + i * PAGE_SIZE);
 			return Status::TRAP;
 		}
 
-		unsigned char entry1 = (startAddress >> PMT1_OFFSET) & PMT_ENTRY_MASK;
-		unsigned char entry2 = (startAddress >> PMT2_OFFSET) & PMT_ENTRY_MASK;
+		VirtualAddress page = startAddress + i * PAGE_SIZE;
+
+		unsigned char entry1 = (page >> PMT1_OFFSET) & PMT_ENTRY_MASK;
+		unsigned char entry2 = (page >> PMT2_OFFSET) & PMT_ENTRY_MASK;
 
 		pmtHead->level2entry[entry1]->entry[entry2].frameAndFlags = 0;
 
-		if (--pmtHead->level2entry[entry1]->entriesUsed == 0) { //Oslobadjanje pm tabele ako su svi ulazi slobodni
+		if (--pmtHead->level2EntriesUsed[entry1] == 0) { //Oslobadjanje pm tabele ako su svi ulazi slobodni
 			KernelSystem::kernelSystem->deallocatePMT(pmtHead->level2entry[entry1], PMTType::LEVEL2_PMT);
 			pmtHead->level2entry[entry1] = nullptr;
 			--pmtHead->entriesUsed;
@@ -412,24 +1045,50 @@ Status KernelProcess::disconnectSharedSegment(const char * name) {
 
 Status KernelProcess::deleteSharedSegment(const char * name) {
 
-	auto segments = KernelSystem::kernelSystem->sharedSegments; //Mapa svih deljenih segmenata
+	auto& segments = KernelSystem::kernelSystem->sharedSegments; //Mapa svih deljenih segmenata
 
 	auto segmentPtr = segments.find(name); //Segment koji se trazi
 
 	if (segmentPtr == segments.end()) {
-		std::cout << "GRESKA: metoda disconnectSharedSegment | Deljeni segment sa zadatim imenom ne postoji.\n";
+		TRACE_ERROR(DELETE_SHARED_NO_SEGMENT, this->pid);
 		return Status::TRAP;
 	}
 	auto segment = segmentPtr->second; //Dohvatanje pokazivaca na deskriptor deljenog segmenta
 
 	auto processes = segment->processes; //Dohvatanje mape procesa koji koriste deljeni segment
 
-	for (auto it : processes) {
-		auto process = KernelSystem::kernelSystem->processMap.find(it.first); //Dohvatanje PCBa procesa koji koristi deljeni segment
+	{
+		std::shared_lock<std::shared_timed_mutex> lock(*KernelSystem::kernelSystem->processMapMutex);
 
-		if (process == KernelSystem::kernelSystem->processMap.end()) continue; //swallow
+		for (auto it : processes) {
+			auto process = KernelSystem::kernelSystem->processMap.find(it.first); //Dohvatanje PCBa procesa koji koristi deljeni segment
 
-		process->second->disconnectSharedSegment(name); //Odvezivanje deljenog segmenta iz procesa koji ga koristi
+			if (process == KernelSystem::kernelSystem->processMap.end()) continue; //swallow
+
+			KernelProcess* kernelProcess = process->second->pProcess;
+
+			DummyMutex dummy(kernelProcess->pmtMutex);
+			kernelProcess->disconnectSharedSegment(name); //Odvezivanje deljenog segmenta iz procesa koji ga koristi
+		}
+	}
+
+	for (PageNum i = 0; i < segment->getSegmentSize(); i++) { //Oslobadjanje frejmova i klastera koje je segment koristio
+		Descriptor& desc = segment->pmt.entry[i];
+
+		DummyMutex dummy(KernelSystem::kernelSystem->evictionMutex);
+
+		unsigned int frameAndFlags = desc.frameAndFlags.exchange(0);
+
+		if (frameAndFlags & V_MASK) {
+			PhysicalAddress frameAddress = KernelSystem::kernelSystem->getFrameAddress(frameAndFlags & FRAME_MASK);
+
+			KernelSystem::kernelSystem->unmapFrame(frameAddress);
+			KernelSystem::kernelSystem->deallocatePage(frameAddress);
+		}
+
+		if (desc.disk != NO_CLUSTER) {
+			KernelSystem::kernelSystem->setClusterFree(desc.disk);
+		}
 	}
 
 	KernelSystem::kernelSystem->spaceAllocator->deallocatePMT(segment->pmt.entry, PMTType::SHARED_SEG_PMT, segment->getSegmentSize()); //Dealociranje tabele deljenog segmenta
@@ -445,23 +1104,23 @@ Status KernelProcess::deleteSharedSegment(const char * name) {
 
 Status KernelProcess::checkSegment(VirtualAddress startAddress, PageNum segmentSize) {
 	if (startAddress & WORD_MASK) { //Provera da li je adresa poravnata na pocetak stranice
-		std::cout << "GRESKA: metoda createSharedSegment | Pocetna adresa nije poravnata na pocetak segmenta.\n";
+		TRACE_ERROR(SEGMENT_NOT_ALIGNED, this->pid, startAddress);
 		return Status::TRAP;
 	}
 
 	if (startAddress + segmentSize * PAGE_SIZE > VIRTUAL_MEMORY_LAST_ADDRESS) { //Provera da li je doslo do prekoracenja segmenta
-		std::cout << "GRESKA: metoda createSharedSegment | Segment izvan granica virtuelne memorije.\n";
+		TRACE_ERROR(SEGMENT_OUT_OF_RANGE, this->pid, startAddress, segmentSize);
 		return Status::TRAP;
 	}
 
 	if (segmentSize == 0) {
-		std::cout << "GRESKA: metoda createSharedSegment | Segment ne moze biti velicine 0.\n";
+		TRACE_ERROR(SEGMENT_EMPTY, this->pid, startAddress);
 		return Status::TRAP;
 	}
 
 	for (PageNum i = 0; i < segmentSize && pmtHead != nullptr; i++) { //Provera da li se zeljeni segment preklapa sa vec dodeljenim.
 		if (this->checkAllocated(startAddress + i * PAGE_SIZE)) {
-			std::cout << "GRESKA: metoda createSharedSegment | Segment se preklapa sa vec alociranim segmentom.\n";
+			TRACE_ERROR(SEGMENT_OVERLAP, this->pid, startAddress, segmentSize);
 			return Status::TRAP;
 		}
 	}
@@ -476,7 +1135,7 @@ bool KernelProcess::checkAllocated(VirtualAddress startAddress) {
 
 	if (this->pmtHead == nullptr) return false; //Ako nije alocirana tabela prvog nivoa, tada ni jedna stranica nije dodeljena procesu
 
-	if (this->pmtHead->level2entry[entry1] == nullptr) return false; //Ako nije u odgovarajucem deskriptoru alocirana tabela drugog nivoa, tada nije ni trazena stranica dodeljena procesu
+	if (this->pmtHead->level2entry[entry1] == nullptr) return this->getSuperpage(startAddress) != nullptr; //Bez tabele drugog nivoa stranica je dodeljena procesu samo kao deo velike stranice
 
 	if (this->pmtHead->level2entry[entry1]->entry[entry2].frameAndFlags & L_MASK) return true; //U odgovarajucem ulazu je alocirana trazena stranica
 
@@ -484,33 +1143,25 @@ bool KernelProcess::checkAllocated(VirtualAddress startAddress) {
 
 }
 
-bool KernelProcess::updatePMT(VirtualAddress page, PhysicalAddress frame, PageNum ordinal, AccessType flags, bool setD, bool setSh, Descriptor* sharedDesc) {
+bool KernelProcess::updatePMT(VirtualAddress page, PhysicalAddress frame, PageNum ordinal, AccessType flags, bool setD, bool setSh, Descriptor* sharedDesc, bool setCow) {
 
 	unsigned char entry1 = (page >> PMT1_OFFSET) & PMT_ENTRY_MASK;
 	unsigned char entry2 = (page >> PMT2_OFFSET) & PMT_ENTRY_MASK;
 
-	if (this->pmtHead == nullptr) { //Ako je true, nije alocirana tabela prvog nivoa
-		PhysicalAddress adr = KernelSystem::kernelSystem->allocatePMT(PMTType::LEVEL1_PMT);
-
-		if (adr == nullptr) { //Ako metoda allocatePmt vrati nullptr znaci da nema dovoljno prostora za PMT
-			std::cout << "GRESKA: Metoda updatePMT | Nema dovoljno prostora za alociranje PMTa.\n";
-			return false;
-		}
-
-		this->pmtHead = (PMT1*)adr;
+	if (!this->allocatePMT1()) { //Ako je true, nije bilo moguce alocirati tabelu prvog nivoa
+		return false;
+	}
 
-		//Inicijalizacija PM tabele prvog nivoa
-		for (int i = 0; i < PMT1_SIZE; i++)
-			this->pmtHead->level2entry[i] = nullptr;
-		
-		this->pmtHead->entriesUsed = 0;
+	if (this->pmtHead->superpage[entry1].frameAndFlags & L_MASK) { //Ulaz tabele prvog nivoa preslikava veliku stranicu
+		TRACE_ERROR(UPDATE_PMT_ALLOCATED, this->pid, page);
+		return false;
 	}
 
 	if (this->pmtHead->level2entry[entry1] == nullptr) { //Ako je true, znaci da u odgovarajucem ulazu tabele 1. nivoa nije alocirana tabela drugog nivoa
 		PhysicalAddress adr = KernelSystem::kernelSystem->allocatePMT(PMTType::LEVEL2_PMT);
 
 		if (adr == nullptr) { //Ako metoda allocatePmt vrati nullptr znaci da nema dovoljno prostora za PMT
-			std::cout << "GRESKA: Metoda updatePMT | Nema dovoljno prostora za alociranje PMTa.\n";
+			TRACE_ERROR(UPDATE_PMT_NO_SPACE, this->pid, page);
 			return false;
 		}
 
@@ -520,14 +1171,13 @@ bool KernelProcess::updatePMT(VirtualAddress page, PhysicalAddress frame, PageNu
 		for (int i = 0; i < PMT2_SIZE; i++) {
 			pmt2->entry[i].frameAndFlags = 0;
 		}
-		pmt2->entriesUsed = 0;
 		
 		++this->pmtHead->entriesUsed; //Povecavanje broja alociranih tabela drugog nivoa
 		this->pmtHead->level2entry[entry1] = pmt2; //Postavljenje pokazivaca u tabeli prvog nivoa da pokazuje na alociranu tabelu drugog nivoa.
 	}
 
 	if (this->pmtHead->level2entry[entry1]->entry[entry2].frameAndFlags & L_MASK) { //Ako je true, odgovarajuci ulaz je zauzet.
-		std::cout << "GRESKA: Metoda updatePMT | U odgovarajucem deskriptoru prosledjene adrese je vec alocirana stranica.\n";
+		TRACE_ERROR(UPDATE_PMT_ALLOCATED, this->pid, page);
 		return false;
 	}
 
@@ -535,20 +1185,30 @@ bool KernelProcess::updatePMT(VirtualAddress page, PhysicalAddress frame, PageNu
 
 	desc.frameAndFlags = 0; //Inicijalno stanje
 	if (setSh) {
-		desc.sharedDesc = sharedDesc;
+		desc.sharedIndex = KernelSystem::kernelSystem->getSharedIndex(sharedDesc);
 		desc.frameAndFlags |= SET_SH;
+		desc.frameAndFlags |= setCow ? SET_COW : 0;
 	}
 	else {
-		desc.disk = 0; //Na pocetku stranica nije swapovana
+		desc.disk = NO_CLUSTER; //Klaster se dodeljuje pri prvom upisu stranice na disk
 	}
 
-	desc.ordinal = ordinal; //Postavljanje rednog broja u segmentu
-	desc.frameAndFlags |= (SET_V | SET_L); //Postavljanje valid i loaded bita
+	desc.frameAndFlags |= (ordinal == 0) ? SET_ST : 0; //Postavljanje bita pocetka segmenta
+	desc.frameAndFlags |= (frame != nullptr) ? (SET_V | SET_L) : SET_L; //Postavljanje valid i loaded bita. Stranica koja se deli sa klonom nema V bit, pa upis ne moze da postavi D bit
 	desc.frameAndFlags |= setD ? SET_D : 0; //Postavljanje D bita
 	desc.frameAndFlags |= (unsigned int)flags << ACCESS_BITS_SHIFT; //Postavljanje prava pristupa
-	desc.frameAndFlags |= (unsigned int)frame >> ADR_WORD; //Postavljanje broja frejma u RAM memoriji
+
+	if (frame != nullptr) {
+		desc.frameAndFlags |= KernelSystem::kernelSystem->getFrameIndex(frame); //Postavljanje broja frejma u RAM memoriji
+	}
+
+	if (!setSh && (frame != nullptr)) { //Frejm deljenog segmenta je vezan za deskriptor segmenta, a ne za deskriptor procesa
+		DummyMutex dummy(KernelSystem::kernelSystem->evictionMutex);
+
+		KernelSystem::kernelSystem->mapFrame(frame, &desc, this->pid, page);
+	}
 	
-	++this->pmtHead->level2entry[entry1]->entriesUsed;
+	++this->pmtHead->level2EntriesUsed[entry1];
 	
 	return true;
 }
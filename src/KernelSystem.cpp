@@ -6,32 +6,71 @@
 #include "SpaceAllocator.h"
 #include "DummyMutex.h"
 #include "FreeSpaceDescriptor.h"
+#include "FrameDescriptor.h"
+#include "ClusterAllocator.h"
 #include "MemoryException.h"
-#include <iostream>
+#include "Trace.h"
+#include "AccessRecorder.h"
+#include "SwapCache.h"
+#include <algorithm>
 #include <unordered_map>
 #include <mutex>
+#include <shared_mutex>
+#include <vector>
 
 
 ProcessId KernelSystem::nextPid = 0;
+unsigned long KernelSystem::nextSystemId = 0;
 KernelSystem* KernelSystem::kernelSystem = nullptr;
 
-KernelSystem::KernelSystem(PhysicalAddress processVMSpace, PageNum processVMSpaceSize, PhysicalAddress pmtSpace, PageNum pmtSpaceSize, Partition* partition, System* mySystem) 
+//Blok brojaca niti i redni broj sistema kome pripada. Posle brisanja sistema nit dobija novi blok od sledeceg sistema.
+static thread_local StatCounters* threadCounters = nullptr;
+static thread_local unsigned long threadCountersSystem = 0;
+
+KernelSystem::KernelSystem(PhysicalAddress processVMSpace, PageNum processVMSpaceSize, PhysicalAddress pmtSpace, PageNum pmtSpaceSize, Partition* partition, System* mySystem, const SystemConfig& config) 
 		: processVMSpace(processVMSpace), processVMSpaceSize(processVMSpaceSize), pmtSpace(pmtSpace),
-			pmtSpaceSize(pmtSpaceSize), partition(partition), mySystem(mySystem) {
+			pmtSpaceSize(pmtSpaceSize), partition(partition), mySystem(mySystem), config(config), writebackHand(0), writebackInProgress(false), prefetchHits(0), counters(nullptr), recorder(nullptr), swapCache(nullptr) {
 	
 	KernelSystem::kernelSystem = this;
+	this->systemId = ++KernelSystem::nextSystemId;
 
 	this->numberOfClusters = this->partition->getNumOfClusters();
+	if (this->numberOfClusters > MAX_DESCRIPTOR_CLUSTER) {
+		this->numberOfClusters = MAX_DESCRIPTOR_CLUSTER;
+	}
+
+	if (processVMSpaceSize > FRAME_MASK + 1) { //Broj frejma mora da stane u deskriptor
+		processVMSpaceSize = this->processVMSpaceSize = FRAME_MASK + 1;
+	}
+
+	if (config.mapPartition) {
+		this->partition->map();
+	}
 	
-	this->referenceBits = new unsigned char[(processVMSpaceSize / REF_BITS_HOLDER_SIZE) + (processVMSpaceSize % REF_BITS_HOLDER_SIZE == 0 ? 0 : 1)]{ 0 };
+	this->frameTable = new FrameDescriptor[processVMSpaceSize];
+
+	this->prefetchedFrames = new std::atomic<bool>[processVMSpaceSize]();
+
+	this->replacementPolicy = ReplacementPolicy::create(config, processVMSpaceSize);
 
 	spaceAllocator = new SpaceAllocator(this, pmtSpace, pmtSpaceSize, processVMSpace, processVMSpaceSize, numberOfClusters, partition);
 
-	freeClusters.push_front(ClustersFree(0, this->numberOfClusters));
-	this->globalMutex = new std::mutex();
+	clusterAllocator = new ClusterAllocator(this->numberOfClusters);
+
+	if (config.swapCacheSize > 0) {
+		swapCache = new SwapCache(this, config.swapCacheSize, config.swapCacheWritebackBatch);
+	}
+
+	this->processMapMutex = new std::shared_timed_mutex();
+	this->sharedSegmentMutex = new std::mutex();
+	this->evictionMutex = new std::mutex();
+	this->clusterMutex = new std::mutex();
+	this->countersMutex = new std::mutex();
 }
 
 KernelSystem::~KernelSystem() {
+	delete recorder; //Snimak koji nije zavrsen sa stopRecording se upisuje do kraja
+
 	std::unordered_map<ProcessId, Process*> map(processMap);
 	for (auto it: map) {
 		if (it.second->pProcess != nullptr)
@@ -39,32 +78,44 @@ KernelSystem::~KernelSystem() {
 		it.second->pProcess = nullptr;
 	}
 
+	delete swapCache; //Stranice u kesu se ne upisuju na disk, sadrzaj particije ne vazi posle brisanja sistema
 	delete spaceAllocator;
-	delete[] referenceBits;
+	delete replacementPolicy;
+	delete[] frameTable;
+	delete[] prefetchedFrames;
+	delete clusterAllocator;
 	processMap.clear();
-	freeClusters.clear();
-	delete globalMutex;
+	delete processMapMutex;
+	delete sharedSegmentMutex;
+	delete evictionMutex;
+	delete clusterMutex;
+	delete countersMutex;
+
+	while (counters != nullptr) {
+		StatCounters* next = counters->next;
+		delete counters;
+		counters = next;
+	}
 
 	KernelSystem::kernelSystem = nullptr;
 }
 
 Time KernelSystem::periodicJob() {
-	
-	return 0;
-
-	/*std::list<FreeSpaceDescriptor>::iterator prev, curr;
-	
-	bool first = true;
+	{
+		DummyMutex dummy(this->evictionMutex);
 
-	while (true) {
-		if (!first) {
-		}
+		this->replacementPolicy->periodicJob();
 	}
-	
-	return 0;*/
+
+	this->writeBack();
+
+	this->partition->flush(); //Upis izmena mapirane particije na disk se radi u pozadini
+
+	return this->config.agingPeriod;
 }
 
 Process* KernelSystem::createProcess() {
+	std::unique_lock<std::shared_timed_mutex> lock(*this->processMapMutex);
 
 	Process* pcb = new Process(++KernelSystem::nextPid);
 
@@ -75,11 +126,17 @@ Process* KernelSystem::createProcess() {
 }
 
 void KernelSystem::deleteProcess(ProcessId pid) {
+	std::unique_lock<std::shared_timed_mutex> lock(*this->processMapMutex);
+
 	this->processMap.erase(pid);
 }
 
 Status KernelSystem::access(ProcessId pid, VirtualAddress address, AccessType type) {
 
+	//Pogodak ne uzima ni jedno ekskluzivno zakljucavanje. Deljeno zakljucavanje mape procesa sprecava samo
+	//brisanje procesa tokom pristupa, a izbacivanje stranice se prepoznaje po V bitu u atomicnim flegovima.
+	std::shared_lock<std::shared_timed_mutex> lock(*this->processMapMutex);
+
 	auto pcbIterator = processMap.find(pid);
 
 	Process *pcb = nullptr;
@@ -90,163 +147,655 @@ Status KernelSystem::access(ProcessId pid, VirtualAddress address, AccessType ty
 
 	//Ako je pcb jednak nullptr-u znaci da proces sa unetim id-jem ne postoji.
 	if (pcb == nullptr) {
-		std::cout << "Metoda Access | Status = TRAP | pcb == nullptr\n";
+		TRACE_INFO(ACCESS_NO_PROCESS, pid);
 		return Status::TRAP;
 	}
 
-	PMT1 *pmtHead = pcb->pProcess->pmtHead; //Uzmi pokazivac na PMT 1. nivoa
+	PageNum frame;
+	Status status = this->translate(pcb->pProcess, address, type, frame);
+
+	StatCounters* counters = this->getCounters();
+	StatCounters::add(counters->accesses);
+	if (status == Status::OK) StatCounters::add(counters->hits);
+	else if (status == Status::PAGE_FAULT) StatCounters::add(counters->faults);
+
+	return status;
+}
+
+Status KernelSystem::translate(KernelProcess* process, VirtualAddress address, AccessType type, PageNum& frame, bool report) {
+	PMT1 *pmtHead = process->pmtHead; //Uzmi pokazivac na PMT 1. nivoa
 
 	if (pmtHead == nullptr) {
-		std::cout << "Metoda Access | Status = TRAP | pmtHead == nullptr\n";
+		TRACE_INFO(ACCESS_NO_PMT1, process->pid, address);
 		return Status::TRAP; //Ako PMT 1. nivoa nije alociran, stranica nije ucitana
 	}
 
 	PMT2 *pmt2 = pmtHead->level2entry[(address >> PMT1_OFFSET) & PMT_ENTRY_MASK]; //Dohvati PMT 2. nivoa
 
-	if (pmt2 == nullptr) {
-		std::cout << "Metoda Access | Status = TRAP | pmt2 == nullptr\n";
+	Descriptor* desc;
+	bool superpage = false;
+
+	if (pmt2 != nullptr) {
+		desc = &pmt2->entry[(address >> PMT2_OFFSET) & PMT_ENTRY_MASK]; //Dohvati pokazivac na deskriptor
+	}
+	else if (pmtHead->superpage[(address >> PMT1_OFFSET) & PMT_ENTRY_MASK].frameAndFlags & L_MASK) { //Ulaz preslikava veliku stranicu
+		desc = &pmtHead->superpage[(address >> PMT1_OFFSET) & PMT_ENTRY_MASK];
+		superpage = true;
+	}
+	else {
+		TRACE_INFO(ACCESS_NO_PMT2, process->pid, address);
 		return Status::PAGE_FAULT; //Ako PMT 2. nivoa nije alocirana, stranica nije ucitana
 	}
 
-	Descriptor& desc = pmt2->entry[(address >> PMT2_OFFSET) & PMT_ENTRY_MASK]; //Dohvati referencu na deskriptor
-
-	if (!(desc.frameAndFlags & L_MASK)) { //Ako je false, stranica nije dodeljena procesu.
-		std::cout << "Metoda Access | Status = TRAP | Trazena stranica nije u memoriji.\n";
+	if (!(desc->frameAndFlags & L_MASK)) { //Ako je false, stranica nije dodeljena procesu.
+		TRACE_INFO(ACCESS_NOT_LOADED, process->pid, address);
 	}
 
-	if (desc.frameAndFlags & SH_MASK) {
-		desc = *desc.sharedDesc; //Ako je deljeni segment dohvati stvarni deskriptor segmenta
+	Descriptor* pageDesc = desc;
+
+	if (desc->frameAndFlags & SH_MASK) {
+		desc = this->getSharedDescriptor(desc); //Ako je deljeni segment dohvati stvarni deskriptor segmenta
 	}
 
-	if (desc.frameAndFlags & V_MASK) { //Ako je setovan V bit, stranica je u memoriji
-		char rights = (desc.frameAndFlags & ACCESS_BITS_MASK) >> ACCESS_BITS_SHIFT; //Dohvati bite za prava
+	unsigned int frameAndFlags = desc->frameAndFlags;
+
+	if (frameAndFlags & V_MASK) { //Ako je setovan V bit, stranica je u memoriji
+		char rights = (frameAndFlags & ACCESS_BITS_MASK) >> ACCESS_BITS_SHIFT; //Dohvati bite za prava
 		if ((rights == type) ||
 			((rights == AccessType::READ_WRITE) && ((type == AccessType::READ) || (type == AccessType::WRITE)))) {
 
 			//std::cout << "Metoda Access | Status = OK | Virtuelna Adresa = " << address << "\t\tTip = " << ((type == AccessType::READ) ? "READ" : (type == AccessType::WRITE) ? "WRITE" : "EXECUTE") << "\n";
 
+			frame = frameAndFlags & FRAME_MASK;
+
+			//Pristup se prijavljuje pre provere D bita. writeBack posle upisa na disk ponovo oznacava kao modifikovane
+			//stranice kojima je u meduvremenu pristupljeno, a posle te provere access vidi da je D bit obrisan.
+			if (frameAndFlags & F_MASK) { //Pristup koji je izazvao page fault je vec prijavljen algoritmu zamene pri ucitavanju
+				desc->frameAndFlags &= RESET_F;
+			}
+			else if (report) {
+				this->replacementPolicy->pageAccessed(frame);
+
+				if (this->prefetchedFrames[frame].load(std::memory_order_relaxed) && this->prefetchedFrames[frame].exchange(false)) {
+					++this->prefetchHits; //Prvi pristup stranici ucitanoj unapred
+				}
+			}
+
 			if (type == AccessType::WRITE) { //Ako proces upisuje u stranicu potrebno je setovati dirty bit
-				desc.frameAndFlags |= SET_D; 
+				if (pageDesc->frameAndFlags & COW_MASK) { //Stranica se deli sa klonom, kopija se pravi u pageFault-u
+					return Status::PAGE_FAULT;
+				}
+
+				frameAndFlags = desc->frameAndFlags;
+
+				//D bit se postavlja samo dok je V bit setovan, inace bi se izgubio upis u stranicu koju izbacivanje vec brise
+				while (!(frameAndFlags & D_MASK)) {
+					if (!(frameAndFlags & V_MASK)) return Status::PAGE_FAULT;
+					if (desc->frameAndFlags.compare_exchange_weak(frameAndFlags, frameAndFlags | SET_D)) break;
+				}
 			}
+
+			frame += superpage ? (address >> PMT2_OFFSET) & PMT_ENTRY_MASK : 0; //Frejm stranice unutar velike stranice
 			
 			return Status::OK; //Ako su prava pristupa jednaka trazenim pravima, vrati OK
 		}
 
 		else {
-			std::cout << "Metoda Access | Status = TRAP | Nema trazeno pravo pristupa\n";
+			TRACE_INFO(ACCESS_NO_RIGHTS, process->pid, address, type);
 			return Status::TRAP; //U suprotnom se vraca TRAP.
 		}
 	}
 	else { //Ako V bit nije setovan, stranica nije u memoriji.
-#ifdef PRINT
-		std::cout << "Metoda Access | Status = PAGE_FAULT | Virtuelna adresa = " << address << "\n";
-#endif
+		TRACE_DEBUG(ACCESS_PAGE_FAULT, process->pid, address);
 		return Status::PAGE_FAULT;
 	}
 }
 
-PhysicalAddress KernelSystem::swapPage() throw(MemoryException) {
+Status KernelSystem::accessBatch(ProcessId pid, const AccessRequest* requests, PageNum count, AccessResult* results) {
+	std::shared_lock<std::shared_timed_mutex> lock(*this->processMapMutex);
+
+	auto pcbIterator = processMap.find(pid);
+
+	if (pcbIterator == processMap.end()) {
+		TRACE_INFO(ACCESS_BATCH_NO_PROCESS, pid, count);
+
+		for (PageNum i = 0; i < count; i++) results[i] = { Status::TRAP, nullptr };
+		return Status::TRAP;
+	}
+
+	KernelProcess* process = pcbIterator->second->pProcess;
+
+	std::vector<VirtualAddress> faults; //Adrese cije stranice nisu u memoriji ili se kopiraju pri upisu
+
+	//Svaki pristup se prijavljuje algoritmu zamene jednom. Upis se prijavljuje neposredno pre provere D bita, a ucitavanje stranica moze
+	//da potrosi tu referencu pre povratka, pa se upisi prevode posle citanja i prijavljuju tek u ponovnoj proveri ako neka stranica nije u memoriji.
+	for (int writes = 0; writes < 2; writes++) {
+		for (PageNum i = 0; i < count; i++) {
+			if ((requests[i].type == AccessType::WRITE) != (writes == 1)) continue;
+
+			PageNum frame;
+			results[i].status = this->translate(process, requests[i].address, requests[i].type, frame, (writes == 0) || faults.empty());
+			results[i].physicalAddress = (results[i].status == Status::OK) ? (char*)processVMSpace + frame * PAGE_SIZE + (requests[i].address & WORD_MASK) : nullptr;
+
+			if (results[i].status == Status::PAGE_FAULT) faults.push_back(requests[i].address);
+		}
+	}
+
+	StatCounters* counters = this->getCounters();
+	StatCounters::add(counters->accesses, count);
+	StatCounters::add(counters->faults, faults.size());
+	for (PageNum i = 0; i < count; i++) {
+		if (results[i].status == Status::OK) StatCounters::add(counters->hits);
+	}
+
+	if (!faults.empty()) {
+		//Adresa cija je stranica poslednja ucitana, njen pristup je prijavljen pri ucitavanju. count ako je poslednje ucitavanje bilo za vise adresa.
+		PageNum lastLoaded = count;
+		for (PageNum i = 0; (i < count) && (faults.size() == 1); i++) {
+			if (results[i].status == Status::PAGE_FAULT) lastLoaded = i;
+		}
+
+		{
+			DummyMutex dummy(process->pmtMutex);
+			process->pageFaults(faults);
+		}
+
+		//Ucitavanje je moglo da izbaci stranicu kojoj je vec pristupljeno ili da pomeri kazaljku algoritma zamene, pa bi writeBack
+		//mogao da obrise D bit stranice u koju proces tek treba da upise. Zato se sve adrese ponovo proveravaju, bez prijave pristupa,
+		//dok jedan prolaz ne prodje bez ucitavanja. Posle tog prolaza se jos jednom prevode i prijavljuju upisi, jer se upis prijavljuje
+		//pre provere D bita, a kasnija ucitavanja su mogla da potrose referencu. Upis cija je stranica poslednja ucitana je vec prijavljen.
+		bool loaded = true;
+
+		while (loaded) {
+			loaded = false;
+
+			for (int writes = 0; writes < 2 && !loaded; writes++) {
+				for (PageNum i = 0; i < count; i++) {
+					if ((results[i].status == Status::TRAP) || ((writes == 1) && (requests[i].type != AccessType::WRITE))) continue;
+
+					PageNum frame;
+					while ((results[i].status = this->translate(process, requests[i].address, requests[i].type, frame, (writes == 1) && (i != lastLoaded))) == Status::PAGE_FAULT) {
+						DummyMutex dummy(process->pmtMutex);
+
+						loaded = true;
+						lastLoaded = i;
+						if (process->pageFault(requests[i].address) == Status::TRAP) {
+							results[i].status = Status::TRAP;
+							break;
+						}
+					}
+
+					results[i].physicalAddress = (results[i].status == Status::OK) ? (char*)processVMSpace + frame * PAGE_SIZE + (requests[i].address & WORD_MASK) : nullptr;
+				}
+			}
+		}
+	}
+
+	for (PageNum i = 0; i < count; i++) {
+		if (results[i].status != Status::OK) return Status::TRAP;
+	}
+
+	return Status::OK;
+}
+
+PhysicalAddress KernelSystem::swapPage() {
 	//std::cout << "Swapping page.\n";
-	while (true) { //Trazenje stranice za izbacivanje po Second chance algoritmu
-		unsigned long byte = this->clockHand / REF_BITS_HOLDER_SIZE;
-		char bit = this->clockHand % REF_BITS_HOLDER_SIZE;
 
-		if (referenceBits[byte] & (1 << bit)) {
-			referenceBits[byte] &= ~(1 << bit);
-			this->clockHand = (this->clockHand + 1) % this->processVMSpaceSize;
+	DummyMutex dummy(this->evictionMutex); //Page fault stranice koja se izbacuje ceka na ovaj mutex pre citanja sa diska
+
+	//Izbacuje se do swapBatchSize stranica odjednom, prvi frejm se vraca pozivaocu, a ostali se vracaju
+	//u listu slobodnih frejmova. Modifikovane stranice se upisuju na disk sortirane po broju klastera,
+	//jednim pozivom za svaki niz susednih klastera. Velika stranica se izbacuje cela i oslobadja sve svoje frejmove.
+	std::vector<PageNum> victims;
+	std::vector<bool> dirtyVictims; //Da li je frejm iz victims deo modifikovane stranice
+	std::vector<std::pair<ClusterNo, const char*>> dirty;
+	struct EvictedPage { PageNum frame; FrameDescriptor frameDesc; unsigned int frameAndFlags; };
+	std::vector<EvictedPage> dirtyPages; //Ulaz tabele frejmova i flegovi modifikovanih stranica pre izbacivanja
+	PageNum skipped = 0; //Velike stranice preskocene jer za njih nema slobodnog niza klastera
+
+	for (PageNum i = 0; i < this->config.swapBatchSize || victims.empty(); i++) {
+		PageNum swappedPage = this->replacementPolicy->selectVictim(); //Izbor stranice za izbacivanje
+
+		if (swappedPage == this->processVMSpaceSize) break;
+
+		const char* pageAdr = (const char*)processVMSpace + swappedPage * PAGE_SIZE; //Adresa pocetka stranice
+
+		Descriptor* desc = frameTable[swappedPage].owner; //Deskriptor stranice koja se izbacuje, za deljene segmente je to vec deskriptor segmenta
+
+		bool superpage = frameTable[swappedPage].superpage;
+		PageNum frames = superpage ? SUPERPAGE_SIZE : 1;
+
+		//writeBack upisuje stranicu na disk iz njenog frejma, pa se stranica ne izbacuje do kraja upisa
+		if (desc->frameAndFlags & LD_MASK) {
+			this->replacementPolicy->pageAccessed(swappedPage);
+
+			if (skipped++ < this->processVMSpaceSize) continue;
+			break;
+		}
+
+		//V i D bit se brisu jednom atomicnom operacijom, posle nje access ne moze da postavi D bit ovoj stranici
+		unsigned int frameAndFlags = desc->frameAndFlags.fetch_and(RESET_V & RESET_D & RESET_F);
+
+		if (frameAndFlags & D_MASK) { //Ako je stranica modifikovana, swapuj je na disk
+			if (desc->disk == NO_CLUSTER) { //Klaster se dodeljuje pri prvom upisu stranice na disk
+				try {
+					if (superpage) desc->disk = this->getFreeClusterRun(SUPERPAGE_SIZE);
+					else this->reserveClusters(swappedPage);
+				}
+				catch (const MemoryException&) {
+					desc->frameAndFlags |= frameAndFlags & (SET_V | SET_D | SET_F); //Stranica ostaje u memoriji
+
+					//Na fragmentisanoj particiji mozda nema samo niza od SUPERPAGE_SIZE klastera, pa se bira sledeca stranica.
+					//Referenca daje velikoj stranici drugu sansu da je algoritam zamene ne bi birao pri svakom izbacivanju.
+					if (superpage && skipped++ < this->processVMSpaceSize / SUPERPAGE_SIZE) {
+						this->replacementPolicy->pageAccessed(swappedPage);
+						continue;
+					}
+
+					//Ako nema slobodnih klastera, izbacuju se samo vec izabrane stranice
+					if (victims.empty()) throw;
+					break;
+				}
+			}
+
+			desc->frameAndFlags |= SET_S;
+			for (PageNum j = 0; j < frames; j++) dirty.push_back({ desc->disk + j, pageAdr + j * PAGE_SIZE });
+
+			dirtyPages.push_back({ swappedPage, frameTable[swappedPage], frameAndFlags });
 		}
 		else {
-			break;
+			writebackStats.cleanEvictions += frames;
+			if (frameTable[swappedPage].cleaned) ++writebackStats.savedWrites;
+		}
+
+		if (this->prefetchedFrames[swappedPage].exchange(false)) ++prefetchStats.unused;
+
+		frameTable[swappedPage] = FrameDescriptor();
+		this->replacementPolicy->pageEvicted(swappedPage);
+
+		for (PageNum j = 0; j < frames; j++) {
+			victims.push_back(swappedPage + j);
+			dirtyVictims.push_back((frameAndFlags & D_MASK) != 0);
 		}
 	}
 
-	unsigned int pageAdr = (unsigned int)processVMSpace + this->clockHand * PAGE_SIZE;
-	unsigned int frame = pageAdr >> 10;
-	
-	PageNum swappedPage = this->clockHand;
-	this->clockHand = (this->clockHand + 1) % this->processVMSpaceSize;
+	if (victims.empty()) {
+		throw MemoryException("Nema stranice koja moze da se izbaci iz memorije");
+	}
 
-	for (auto it = processMap.begin(); it != processMap.end(); ++it) {
-		Descriptor* desc = this->checkTables(it->second->pProcess->pmtHead, frame); //Provera da li je trenutni proces alocirao trazenu stranicu
-		
-		if (desc != nullptr) { //Ako je desc razlicito od nullptr onda je proces ukazan sa it alocirao trazenu stranicu
-			
-			if (desc->frameAndFlags & SH_MASK) {
-				desc = desc->sharedDesc;
-				//frameAndFlags = desc->frameAndFlags;
-			}
-			unsigned int frameAndFlags = desc->frameAndFlags;
-			
-			if (frameAndFlags & V_MASK) {
-				if (frameAndFlags & D_MASK) { //Ako je stranica modifikovana, swapuj je na disk
-					const char* buffer = (const char*)((frameAndFlags & FRAME_MASK) << ADR_WORD); //Adresa pocetka stranice
-
-					if (!(frameAndFlags & S_MASK)) { //Ako je bila swapovana, vec joj je dodeljen broj klastera, i nalazi se u njenom deskriptoru, u suprotnom dohvati slobodan klaster
-						ClusterNo cluster = this->getFreeCluster();
-						desc->disk = cluster;
-						frameAndFlags |= SET_S;
-					}
+	if (!this->writeClusterRuns(dirty)) {
+		//Modifikovane stranice nisu na disku, pa se vracaju u memoriju kakve su bile pre izbacivanja, kao u writeBack-u.
+		//Ciste stranice su izbacene, a njihovi frejmovi se vracaju u listu slobodnih.
+		for (const EvictedPage& page : dirtyPages) {
+			Descriptor* desc = page.frameDesc.owner;
 
-					if (!this->partition->writeCluster(desc->disk, buffer)) { //upisi na klaster
-						throw MemoryException("Greska pri upisu stranice na klaster");
-					}
+			desc->frameAndFlags |= page.frameAndFlags & (SET_V | SET_D | SET_F);
+			if (!(page.frameAndFlags & S_MASK)) desc->frameAndFlags &= RESET_S; //Klaster jos nema sadrzaj stranice
+
+			frameTable[page.frame] = page.frameDesc;
+			this->replacementPolicy->pageLoaded(page.frame, this->getPageKey(page.frameDesc));
+		}
+
+		for (size_t i = 0; i < victims.size(); i++) {
+			if (!dirtyVictims[i]) this->deallocatePage((char*)processVMSpace + victims[i] * PAGE_SIZE);
+		}
+
+		throw MemoryException("Greska pri upisu stranice na klaster");
+	}
+
+	writebackStats.evictionWrites += dirty.size();
+
+	for (size_t i = 1; i < victims.size(); i++) {
+		this->deallocatePage((char*)processVMSpace + victims[i] * PAGE_SIZE);
+	}
+
+	return (char*)processVMSpace + victims[0] * PAGE_SIZE;
+}
+
+void KernelSystem::writeBack() {
+	if (this->config.writebackBatchSize == 0) return;
+
+	//D bit se brise pre upisa, pa upis u stranicu tokom upisa na disk ponovo oznacava stranicu kao modifikovanu.
+	//Stranice se biraju pod evictionMutex-om i dobijaju LD bit, pa ih izbacivanje preskace, a upis na disk se radi bez zakljucavanja.
+	std::vector<std::pair<ClusterNo, const char*>> dirty;
+	std::vector<std::pair<PageNum, ClusterNo>> cleaned; //Frejm i klaster izabrane stranice
+
+	{
+		DummyMutex dummy(this->evictionMutex);
+
+		if (this->writebackInProgress) return; //Upis iz prethodnog poziva jos traje
+
+		PageNum dirtyFrames = 0;
+
+		for (PageNum frame = 0; frame < this->processVMSpaceSize; frame++) {
+			Descriptor* desc = frameTable[frame].owner;
+			if (desc != nullptr && !frameTable[frame].superpage && (desc->frameAndFlags & D_MASK)) ++dirtyFrames;
+		}
+
+		if (dirtyFrames == 0 || dirtyFrames * 100 < this->processVMSpaceSize * this->config.writebackStartRatio) return;
+
+		//Previse modifikovanih stranica, upisuju se sve neaktivne umesto najvise writebackBatchSize
+		PageNum batchSize = (dirtyFrames * 100 >= this->processVMSpaceSize * this->config.writebackUrgentRatio) ? this->processVMSpaceSize : this->config.writebackBatchSize;
+
+		for (PageNum scanned = 0; scanned < this->processVMSpaceSize && dirty.size() < batchSize; scanned++) {
+			PageNum frame = this->writebackHand;
+			this->writebackHand = (this->writebackHand + 1) % this->processVMSpaceSize;
+
+			Descriptor* desc = frameTable[frame].owner;
+
+			if (desc == nullptr || !(desc->frameAndFlags & D_MASK)) continue;
+
+			if (frameTable[frame].superpage) continue; //Velika stranica se upisuje na disk samo pri izbacivanju
+
+			//Proces upisuje u stranicu posle access-a koji je vratio OK, pa bi upis u stranicu koja se jos koristi mogao
+			//da stigne posle kopiranja na disk i da se izgubi kad se stranica izbaci kao cista
+			if (!this->replacementPolicy->isIdle(frame)) continue;
+
+			if (desc->disk == NO_CLUSTER) {
+				try {
+					this->reserveClusters(frame);
 				}
+				catch (const MemoryException&) { //Nema slobodnih klastera, stranice ce biti upisane pri izbacivanju ako se klasteri oslobode
+					break;
+				}
+			}
 
-				frameAndFlags &= RESET_V;
-				frameAndFlags &= RESET_D;
+			desc->frameAndFlags |= SET_S | SET_LD;
+			desc->frameAndFlags &= RESET_D;
+			frameTable[frame].cleaned = true;
 
-				desc->frameAndFlags = frameAndFlags;
+			dirty.push_back({ desc->disk, (const char*)processVMSpace + frame * PAGE_SIZE });
+			cleaned.push_back({ frame, desc->disk });
+		}
+
+		if (dirty.empty()) return;
+
+		this->writebackInProgress = true;
+
+		DummyMutex clusters(this->clusterMutex);
+
+		for (auto& page : cleaned) this->writebackClusters.push_back(page.second);
+		std::sort(this->writebackClusters.begin(), this->writebackClusters.end());
+	}
+
+	bool written = this->writeClusterRuns(dirty);
+
+	std::vector<ClusterNo> deferred;
+
+	{
+		DummyMutex dummy(this->evictionMutex);
+
+		//Stranica kojoj je pristupljeno izmedju provere i upisa na disk je mozda izmenjena posle kopiranja, pa ostaje modifikovana.
+		//Ako upis nije uspeo, stranice ostaju modifikovane i upisace se pri izbacivanju. Stranica koja je u meduvremenu obrisana
+		//nema vise frejm sa istim klasterom, a stranica koja je presla na zajednicki deskriptor klona zadrzava frejm, klaster i LD bit.
+		for (auto& page : cleaned) {
+			Descriptor* desc = frameTable[page.first].owner;
 
+			if ((desc == nullptr) || (desc->disk != page.second) || ((desc->frameAndFlags & (V_MASK | FRAME_MASK)) != (SET_V | page.first))) continue;
+
+			desc->frameAndFlags &= RESET_LD;
+
+			if (!written || !this->replacementPolicy->isIdle(page.first)) {
+				desc->frameAndFlags |= SET_D;
+				frameTable[page.first].cleaned = false;
 			}
-			break;
 		}
-			
+
+		if (written) writebackStats.backgroundWrites += dirty.size();
+		else TRACE_ERROR(WRITEBACK_WRITE_FAILED, 0, dirty.size());
+
+		this->writebackInProgress = false;
+
+		DummyMutex clusters(this->clusterMutex);
+
+		this->writebackClusters.clear();
+		deferred.swap(this->deferredClusterFrees);
 	}
 
-	return (PhysicalAddress)pageAdr;
+	for (ClusterNo cluster : deferred) this->setClusterFree(cluster);
 }
 
-Descriptor* KernelSystem::checkTables(PMT1 * pmt1, unsigned int frame) {
-	if (pmt1 == nullptr) return nullptr;
+bool KernelSystem::writeClusterRuns(std::vector<std::pair<ClusterNo, const char*>>& pages) {
+	std::sort(pages.begin(), pages.end());
 
-	for (int i = 0; i < PMT1_SIZE; i++) {
-		if (pmt1->level2entry[i] == nullptr) continue;
-		
-		PMT2* pmt2 = pmt1->level2entry[i];
+	if (this->swapCache != nullptr) {
+		return this->swapCache->write(pages);
+	}
 
-		for (int j = 0; j < PMT2_SIZE; j++) {
-			unsigned int frameAndFlags = pmt2->entry[j].frameAndFlags;
+	return this->writePartitionRuns(pages);
+}
 
-			if ((frameAndFlags & L_MASK) && (frameAndFlags && V_MASK) 
-				&& ((frameAndFlags & FRAME_MASK) == frame)) { //Ako je dodeljena stranica procesu, ako je u memoriji i ako se broj frejma poklapa sa trazenim frejmom
-				
-				return &pmt2->entry[j];
-			}
-		} //Kraj iteriranja kroz stranicu drugog nivoa
+bool KernelSystem::writePartitionRuns(const std::vector<std::pair<ClusterNo, const char*>>& pages) {
+	std::vector<const char*> buffers;
+	for (size_t run = 0; run < pages.size(); run += buffers.size()) {
+		buffers.clear();
+
+		do { //Skupljanje niza susednih klastera
+			buffers.push_back(pages[run + buffers.size()].second);
+		} while (run + buffers.size() < pages.size() && pages[run + buffers.size()].first == pages[run].first + buffers.size());
+
+		if (!this->partition->writeClusters(pages[run].first, buffers.size(), buffers.data())) { //upisi na klastere
+			return false;
+		}
 	}
 
-	return nullptr;
+	return true;
 }
 
-ClusterNo KernelSystem::getFreeCluster() throw(MemoryException) {
-	if (freeClusters.empty()) throw MemoryException("Nema slobodnih klastera na disku");
+PageNum KernelSystem::getFrameIndex(PhysicalAddress frame) const {
+	return ((char*)frame - (char*)processVMSpace) / PAGE_SIZE;
+}
 
-	std::list<ClustersFree>::iterator begin = freeClusters.begin();
+PhysicalAddress KernelSystem::getFrameAddress(PageNum frame) const {
+	return (char*)processVMSpace + frame * PAGE_SIZE;
+}
 
-	ClusterNo cluster = (*begin).first;
-	
-	if (--(*begin).num == 0) {
-		freeClusters.pop_front();
+Descriptor* KernelSystem::getSharedDescriptor(const Descriptor* desc) const {
+	return (Descriptor*)pmtSpace + desc->sharedIndex;
+}
+
+unsigned int KernelSystem::getSharedIndex(const Descriptor* sharedDesc) const {
+	return sharedDesc - (Descriptor*)pmtSpace;
+}
+
+void KernelSystem::mapFrame(PhysicalAddress frame, Descriptor* owner, ProcessId pid, VirtualAddress page, bool shared, bool prefetched, bool superpage) {
+	PageNum index = this->getFrameIndex(frame);
+	FrameDescriptor& frameDesc = frameTable[index];
+
+	frameDesc.owner = owner;
+	frameDesc.shared = shared;
+	frameDesc.pid = pid;
+	frameDesc.page = page;
+	frameDesc.cleaned = false;
+	frameDesc.superpage = superpage;
+
+	if (prefetched) {
+		++prefetchStats.prefetched;
+		this->replacementPolicy->pagePrefetched(index, this->getPageKey(frameDesc));
 	}
 	else {
-		++(*begin).first;
+		this->replacementPolicy->pageLoaded(index, this->getPageKey(frameDesc));
 	}
 
-	return cluster;
+	this->prefetchedFrames[index] = prefetched;
+}
+
+void KernelSystem::unmapFrame(PhysicalAddress frame) {
+	PageNum index = this->getFrameIndex(frame);
+
+	if (this->prefetchedFrames[index].exchange(false)) ++prefetchStats.unused;
+
+	frameTable[index] = FrameDescriptor();
+
+	this->replacementPolicy->frameFreed(index);
+}
+
+void KernelSystem::setFrameOwner(PageNum frame, Descriptor* owner, ProcessId pid, VirtualAddress page, bool shared) {
+	FrameDescriptor& frameDesc = frameTable[frame];
+
+	frameDesc.owner = owner;
+	frameDesc.pid = pid;
+	frameDesc.page = page;
+	frameDesc.shared = shared;
+}
+
+SystemStats KernelSystem::getStats() {
+	SystemStats stats;
+
+	{
+		DummyMutex dummy(this->countersMutex);
+
+		for (StatCounters* threadStats = this->counters; threadStats != nullptr; threadStats = threadStats->next) {
+			stats.accesses += threadStats->accesses.load(std::memory_order_relaxed);
+			stats.hits += threadStats->hits.load(std::memory_order_relaxed);
+			stats.faults += threadStats->faults.load(std::memory_order_relaxed);
+			stats.clusterReads += threadStats->clusterReads.load(std::memory_order_relaxed);
+		}
+	}
+
+	{
+		DummyMutex dummy(this->evictionMutex);
+
+		stats.cleanEvictions = this->writebackStats.cleanEvictions;
+		stats.dirtyEvictions = this->writebackStats.evictionWrites;
+		stats.evictions = stats.cleanEvictions + stats.dirtyEvictions;
+		stats.clusterWrites = this->writebackStats.evictionWrites + this->writebackStats.backgroundWrites;
+	}
+
+	{
+		DummyMutex dummy(this->spaceAllocator->memoryMutex);
+		stats.freeFrames = this->spaceAllocator->getFreeFrames();
+	}
+	stats.totalFrames = this->processVMSpaceSize;
+
+	{
+		DummyMutex dummy(this->clusterMutex);
+		stats.freeClusters = this->clusterAllocator->getFreeClusters();
+	}
+	stats.totalClusters = this->numberOfClusters;
+
+	{
+		DummyMutex dummy(this->spaceAllocator->pmtSpaceMutex);
+		stats.pmtSpaceUsed = this->spaceAllocator->pmtSpaceUsed;
+		stats.pmtFreeRegions = this->spaceAllocator->pmtFreeSpace.size();
+
+		for (const FreeSpaceDescriptor& region : this->spaceAllocator->pmtFreeSpace) {
+			stats.pmtLargestFreeRegion = std::max(stats.pmtLargestFreeRegion, region.size);
+		}
+	}
+	stats.pmtSpaceSize = (size_t)this->pmtSpaceSize * PAGE_SIZE;
+
+	if (this->swapCache != nullptr) {
+		stats.swapCache = this->swapCache->getStats();
+	}
+
+	std::shared_lock<std::shared_timed_mutex> lock(*this->processMapMutex);
+
+	for (auto it : this->processMap) {
+		ProcessStats processStats;
+		processStats.pid = it.first;
+
+		DummyMutex dummy(it.second->pProcess->pmtMutex);
+		it.second->pProcess->countPages(processStats.residentPages, processStats.swappedPages);
+
+		stats.processes.push_back(processStats);
+	}
+
+	return stats;
+}
+
+StatCounters* KernelSystem::getCounters() {
+	if (threadCountersSystem != this->systemId) {
+		StatCounters* threadStats = new StatCounters();
+
+		DummyMutex dummy(this->countersMutex);
+		threadStats->next = this->counters;
+		this->counters = threadStats;
+
+		threadCounters = threadStats;
+		threadCountersSystem = this->systemId;
+	}
+
+	return threadCounters;
+}
+
+PageKey KernelSystem::getPageKey(const FrameDescriptor& frameDesc) const {
+	if (frameDesc.shared) { //Stranica deljenog segmenta je odredjena svojim deskriptorom u PMT-u segmenta
+		return (PageKey)frameDesc.owner;
+	}
+
+	return ((PageKey)1 << 63) | ((PageKey)frameDesc.pid << 32) | frameDesc.page;
+}
+
+ClusterNo KernelSystem::getFreeCluster() {
+	DummyMutex dummy(this->clusterMutex);
+
+	return this->clusterAllocator->allocate();
+}
+
+ClusterNo KernelSystem::getFreeClusterRun(ClusterNo count) {
+	DummyMutex dummy(this->clusterMutex);
+
+	return this->clusterAllocator->allocateRun(count);
 }
 
 void KernelSystem::setClusterFree(ClusterNo cluster) {
-	this->freeClusters.push_front(ClustersFree(cluster, 1));
+	{
+		DummyMutex dummy(this->clusterMutex);
+
+		//Stranica je obrisana dok writeBack upisuje na njen klaster, klaster se oslobadja posle upisa
+		if (std::binary_search(this->writebackClusters.begin(), this->writebackClusters.end(), cluster)) {
+			this->deferredClusterFrees.push_back(cluster);
+			return;
+		}
+	}
+
+	if (this->swapCache != nullptr) { //Pre oslobadjanja, inace bi mogla da se obrise stranica koja je upisana na klaster kad je ponovo dodeljen
+		this->swapCache->invalidate(cluster);
+	}
+
+	DummyMutex dummy(this->clusterMutex);
+
+	this->clusterAllocator->free(cluster);
+}
+
+void KernelSystem::reserveClusters(PageNum frame) {
+	const FrameDescriptor& frameDesc = frameTable[frame];
+	Descriptor* desc = frameDesc.owner;
+
+	if (frameDesc.shared) { //Deskriptor deljenog segmenta ili zajednicke stranice nije u PMT-u procesa, pa se susedi ne traze
+		desc->disk = this->getFreeCluster();
+		return;
+	}
+
+	//Tabela drugog nivoa se ne dealocira dok je stranica u frejmu. Klaster susedne stranice se menja samo pod evictionMutex-om,
+	//a stranica sa SH bitom u disk polju cuva sharedIndex i nema svoj klaster.
+	PageNum index = (frameDesc.page >> PMT2_OFFSET) & PMT_ENTRY_MASK;
+	Descriptor* entry = desc - index;
+
+	auto unreserved = [](const Descriptor& d) {
+		unsigned int frameAndFlags = d.frameAndFlags;
+		return (frameAndFlags & L_MASK) && !(frameAndFlags & SH_MASK) && (d.disk == NO_CLUSTER);
+	};
+
+	PageNum first = index, last = index;
+
+	while ((first > 0) && !(entry[first].frameAndFlags & ST_MASK) && unreserved(entry[first - 1])) --first;
+
+	while ((last + 1 < PMT2_SIZE) && !(entry[last + 1].frameAndFlags & ST_MASK) && unreserved(entry[last + 1])) ++last;
+
+	ClusterNo base;
+	try {
+		base = this->getFreeClusterRun(last - first + 1);
+	}
+	catch (const MemoryException&) { //Nema dovoljno dugackog niza slobodnih klastera, klaster dobija samo stranica koja se upisuje
+		desc->disk = this->getFreeCluster();
+		return;
+	}
+
+	for (PageNum i = first; i <= last; i++) {
+		entry[i].disk = base + (i - first);
+	}
 }
 
 PhysicalAddress KernelSystem::allocatePMT(PMTType type) {
@@ -261,29 +810,63 @@ void KernelSystem::deallocatePage(PhysicalAddress page) {
 	this->spaceAllocator->deallocatePage(page);
 }
 
-PhysicalAddress KernelSystem::allocatePage() throw(MemoryException) {
+PhysicalAddress KernelSystem::allocatePage() {
 	return this->spaceAllocator->allocatePage();
 }
 
+PhysicalAddress KernelSystem::allocateFreePage() {
+	return this->spaceAllocator->allocateFreePage();
+}
+
+PhysicalAddress KernelSystem::allocateAlignedRun(PageNum count) {
+	return this->spaceAllocator->allocateAlignedRun(count);
+}
+
+void KernelSystem::deallocatePages(PhysicalAddress first, PageNum count) {
+	this->spaceAllocator->deallocatePages(first, count);
+}
+
 Process* KernelSystem::cloneProcess(ProcessId pid) {
-	
-	Process* newPcb = new Process(++KernelSystem::nextPid); //PCB novog procesa
 
-	this->processMap.insert({ newPcb->getProcessId(), newPcb }); //Ubacivanje PCB-a novog procesa u mapu svih procesa
+	std::unique_lock<std::mutex> sharedLock(*this->sharedSegmentMutex); //Kopiranje deljenih segmenata menja njihove spiskove procesa
 
-	auto it = this->processMap.find(pid); //Pronalazenje pokazivaca na pcb procesa koji se kopira
+	Process *oldPcb, *newPcb;
+	{
+		std::unique_lock<std::shared_timed_mutex> lock(*this->processMapMutex);
 
-	if (it == this->processMap.end()) {
-		std::cout << "GRESKA: metoda cloneProcess | Ne postoji proces sa prosledjenim ID-jem\n";
-		return nullptr;
+		auto it = this->processMap.find(pid); //Pronalazenje pokazivaca na pcb procesa koji se kopira
+
+		if (it == this->processMap.end()) {
+			TRACE_ERROR(CLONE_NO_PROCESS, pid);
+			return nullptr;
+		}
+
+		oldPcb = it->second;
+		newPcb = new Process(++KernelSystem::nextPid); //PCB novog procesa
+
+		this->processMap.insert({ newPcb->getProcessId(), newPcb }); //Ubacivanje PCB-a novog procesa u mapu svih procesa
 	}
 
-	KernelProcess *oldKP = it->second->pProcess, *newKP = newPcb->pProcess; //PCB procesa koji se kopira
+	KernelProcess *oldKP = oldPcb->pProcess, *newKP = newPcb->pProcess; //PCB procesa koji se kopira
+
+	std::unique_lock<std::mutex> pmtLock(*oldKP->pmtMutex); //Segmenti procesa koji se kopira se ne menjaju tokom kopiranja
 
 	if (oldKP->pmtHead == nullptr) {
 		return newPcb;
 	}
 
+	//Stranice se sa klonom dele pojedinacno, pa se velike stranice procesa prvo dele na obicne
+	for (unsigned int entry = 0; entry < PMT1_SIZE; entry++) {
+		if ((oldKP->pmtHead->superpage[entry].frameAndFlags & L_MASK) && !oldKP->splitSuperpage((VirtualAddress)entry << PMT1_OFFSET)) {
+			TRACE_ERROR(CLONE_NO_PMT_SPACE, pid);
+
+			pmtLock.unlock();
+			sharedLock.unlock(); //Destruktor procesa zakljucava sharedSegmentMutex
+			delete newPcb;
+			return nullptr;
+		}
+	}
+
 	bool shared; //Indikator da li je trenutni segment deljen
 	unsigned int i = 0, j = 0;
 	PageNum segmentSize = 0; //Velicina trenutnog segmenta
@@ -306,13 +889,14 @@ Process* KernelSystem::cloneProcess(ProcessId pid) {
 
 		while (j < PMT2_SIZE) { //Itearacija kroz PMT 2. nivoa
 			PMT2* oldPmt2 = oldKP->pmtHead->level2entry[i];
-			if ((oldPmt2->entry[j].frameAndFlags & L_MASK) && (segmentSize == oldPmt2->entry[j].ordinal)) { //Ako je L bit setovan i velicina segmenta je jednaka rednom broju stranice u segmentu, ili smo nasli nov segment ili smo jos uvek u vec pronadjenom
+			unsigned int frameAndFlags = oldPmt2->entry[j].frameAndFlags;
+			if ((frameAndFlags & L_MASK) && ((segmentSize == 0) == ((frameAndFlags & ST_MASK) != 0))) { //Ako je L bit setovan i ST bit je postavljen samo na pocetku segmenta, ili smo nasli nov segment ili smo jos uvek u vec pronadjenom
 				if (segmentSize == 0) { //Pronadjen je novi segment, iniciranje potrebnih promenljivih
 					startAddress = 0;
 					startAddress |= (unsigned long)i << PMT1_OFFSET;
 					startAddress |= (unsigned long)j << PMT2_OFFSET;
 					
-					if (oldPmt2->entry[j].frameAndFlags & SH_MASK) shared = true;
+					if ((frameAndFlags & SH_MASK) && !(frameAndFlags & COW_MASK)) shared = true; //Stranice deljene sa klonom pripadaju segmentu procesa
 					else shared = false;
 				
 					flags = (AccessType)((oldPmt2->entry[j].frameAndFlags & ACCESS_BITS_MASK) >> ACCESS_BITS_SHIFT);
@@ -343,6 +927,12 @@ void KernelSystem::copyContent(const char * src, char * dst) {
 	}
 }
 
+void KernelSystem::clearContent(char* dst) {
+	for (unsigned long i = 0; i < PAGE_SIZE; i++) {
+		dst[i] = 0;
+	}
+}
+
 void KernelSystem::initSegment(VirtualAddress startAddress, KernelProcess* newKP, KernelProcess* oldKP, PageNum segmentSize, ProcessId pid, AccessType flags, bool shared) {
 
 	if (shared) {
@@ -364,36 +954,131 @@ void KernelSystem::initSegment(VirtualAddress startAddress, KernelProcess* newKP
 	}
 
 	else {
-		newKP->createSegment(startAddress, segmentSize, flags);
+		//Novi proces deli frejmove i klastere stranica sa procesom koji se kopira, a kopija stranice
+		//se pravi tek pri prvom upisu jednog od njih
 		for (PageNum k = 0; k < segmentSize; k++) {
 			VirtualAddress page = startAddress + k * PAGE_SIZE; //Dohvatanje pocetne adrese stranica
 
 			unsigned char entry1 = (page >> PMT1_OFFSET) & PMT_ENTRY_MASK; //Ulaz u tabeli prvog nivoa
 			unsigned char entry2 = (page >> PMT2_OFFSET) & PMT_ENTRY_MASK; //Ulaz u tabeli drugog nivoa
 
-			Descriptor& oldDesc = oldKP->pmtHead->level2entry[entry1]->entry[entry2];
-			Descriptor& newDesc = newKP->pmtHead->level2entry[entry1]->entry[entry2];
+			Descriptor* oldDesc = &oldKP->pmtHead->level2entry[entry1]->entry[entry2];
 
-			if (!(newDesc.frameAndFlags & V_MASK)) { //Ako je stranica u koju je potrebno iskopirati sadrzaj bila zamenjenea
-				newKP->pageFault(page);
-			}
+			Descriptor* cowDesc = this->shareCowPage(oldDesc);
 
-			if ((oldDesc.frameAndFlags & S_MASK) && !(oldDesc.frameAndFlags & V_MASK)) {//Menjan je, svapovan je i nije u memoriji
-				PhysicalAddress dst = newKP->getPhysicalAddress(page);
+			if (cowDesc == nullptr) {
+				TRACE_ERROR(CLONE_NO_COW_SPACE, pid, page);
+				return;
+			}
 
-				this->partition->readCluster(oldDesc.disk, (char*)dst);
+			if (!newKP->updatePMT(page, nullptr, k, flags, false, true, cowDesc, true)) {
+				DummyMutex dummy(this->evictionMutex);
 
-				newDesc.frameAndFlags |= SET_D;
+				this->releaseCowPage(cowDesc);
+				return;
 			}
+		}
+	}
+}
 
-			else if ((oldDesc.frameAndFlags & V_MASK) && ((oldDesc.frameAndFlags & D_MASK) || (oldDesc.frameAndFlags & S_MASK))) { //U memoriji je ali je ili menjan ili je bio swapovan
-				PhysicalAddress src = oldKP->getPhysicalAddress(page); //Fizicka adresa izvorista
-				PhysicalAddress dst = newKP->getPhysicalAddress(page); //Fizicka adresa odredista
+Descriptor* KernelSystem::shareCowPage(Descriptor* desc) {
+	if (desc->frameAndFlags & COW_MASK) { //Stranica se vec deli sa nekim klonom
+		Descriptor* cowDesc = this->getSharedDescriptor(desc);
 
-				this->copyContent((const char*)src, (char*)dst); //Kopiranje sadrzaja
+		DummyMutex dummy(this->evictionMutex);
 
-				newDesc.frameAndFlags |= SET_D;
-			}
+		++((CowDescriptor*)cowDesc)->refCount;
+		return cowDesc;
+	}
+
+	CowDescriptor* cow = (CowDescriptor*)this->allocatePMT(PMTType::COW_DESCRIPTOR);
+
+	if (cow == nullptr) {
+		return nullptr;
+	}
+
+	DummyMutex dummy(this->evictionMutex); //Frejm i klaster stranice prelaze na zajednicki deskriptor, stranica ne sme biti izbacena tokom prelaska
+
+	const unsigned int moved = FRAME_MASK | ACCESS_BITS_MASK | V_MASK | D_MASK | S_MASK | F_MASK | L_MASK | LD_MASK; //LD bit ima stranica koju writeBack upisuje
+
+	cow->desc.disk = desc->disk;
+	cow->desc.frameAndFlags = desc->frameAndFlags & moved;
+	cow->refCount = 2;
+
+	//Access cita sharedIndex samo ako je SH bit postavljen, a disk se cita samo pod evictionMutex-om. Deskriptor procesa
+	//nema V bit, pa upis koji je procitao stare flegove ne moze da postavi D bit u njemu i dobija PAGE_FAULT.
+	desc->sharedIndex = this->getSharedIndex(&cow->desc);
+
+	unsigned int frameAndFlags = desc->frameAndFlags.exchange((desc->frameAndFlags & (ACCESS_BITS_MASK | L_MASK | ST_MASK)) | SET_SH | SET_COW);
+
+	cow->desc.frameAndFlags |= frameAndFlags & D_MASK; //Upis koji je stigao pre zamene flegova
+
+	if (frameAndFlags & V_MASK) {
+		PageNum frame = frameAndFlags & FRAME_MASK;
+		FrameDescriptor& frameDesc = frameTable[frame];
+
+		this->setFrameOwner(frame, &cow->desc, frameDesc.pid, frameDesc.page, true);
+	}
+
+	return &cow->desc;
+}
+
+void KernelSystem::releaseCowPage(Descriptor* cowDesc) {
+	CowDescriptor* cow = (CowDescriptor*)cowDesc;
+
+	if (--cow->refCount > 0) return;
+
+	unsigned int frameAndFlags = cowDesc->frameAndFlags.exchange(0);
+
+	if (frameAndFlags & V_MASK) {
+		PhysicalAddress frameAddress = this->getFrameAddress(frameAndFlags & FRAME_MASK);
+
+		this->unmapFrame(frameAddress);
+		this->deallocatePage(frameAddress);
+	}
+
+	if (cowDesc->disk != NO_CLUSTER) {
+		this->setClusterFree(cowDesc->disk);
+	}
+
+	this->deallocatePMT(cow, PMTType::COW_DESCRIPTOR);
+}
+
+void KernelSystem::readPage(Descriptor* desc, char* buffer) {
+	ClusterNo cluster;
+	{
+		DummyMutex dummy(this->evictionMutex);
+
+		unsigned int frameAndFlags = desc->frameAndFlags;
+
+		if (frameAndFlags & V_MASK) {
+			this->copyContent((const char*)this->getFrameAddress(frameAndFlags & FRAME_MASK), buffer);
+			return;
 		}
+
+		if (!(frameAndFlags & S_MASK)) { //Stranica nije ni menjana ni swapovana
+			this->clearContent(buffer);
+			return;
+		}
+
+		cluster = desc->disk; //Izbacena stranica je vec upisana na disk, jer se upis radi pod evictionMutex-om
 	}
+
+	this->readClusters(cluster, 1, &buffer);
+}
+
+bool KernelSystem::readClusters(ClusterNo first, ClusterNo count, char* const* buffers) {
+	ClusterNo diskReads = count;
+	bool read;
+
+	if (this->swapCache != nullptr) {
+		read = this->swapCache->read(first, count, buffers, diskReads);
+	}
+	else {
+		read = this->partition->readClusters(first, count, buffers);
+	}
+
+	if (read) StatCounters::add(this->getCounters()->clusterReads, diskReads);
+
+	return read;
 }
\ No newline at end of file
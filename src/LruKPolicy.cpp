@@ -0,0 +1,106 @@
+#include "LruKPolicy.h"
+
+LruKPolicy::LruKPolicy(PageNum numberOfFrames, unsigned int k) 
+	: numberOfFrames(numberOfFrames), k(k > 0 ? k : 1), currentTime(0) {
+	
+	this->history = new std::atomic<Timestamp>[numberOfFrames * this->k]();
+	this->keys = new PageKey[numberOfFrames]{ 0 };
+	this->loaded = new bool[numberOfFrames]{ false };
+}
+
+LruKPolicy::~LruKPolicy() {
+	for (auto it : retained) {
+		delete[] it.second.times;
+	}
+
+	delete[] history;
+	delete[] keys;
+	delete[] loaded;
+}
+
+void LruKPolicy::pageAccessed(PageNum frame) {
+	std::atomic<Timestamp>* times = history + frame * k;
+
+	//Istovremeni pogoci u isti frejm mogu da izgube po jednu referencu, sto algoritam trpi
+	for (unsigned int i = k - 1; i > 0; i--) {
+		times[i].store(times[i - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+	times[0].store(currentTime.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void LruKPolicy::pageLoaded(PageNum frame, PageKey key) {
+	this->pagePrefetched(frame, key);
+	this->pageAccessed(frame); //Ucitavanje stranice se racuna kao referenciranje
+}
+
+void LruKPolicy::pagePrefetched(PageNum frame, PageKey key) {
+	std::atomic<Timestamp>* times = history + frame * k;
+	auto old = retained.find(key);
+
+	if (old != retained.end()) { //Vracanje istorije izbacene stranice
+		for (unsigned int i = 0; i < k; i++) times[i] = old->second.times[i];
+
+		delete[] old->second.times;
+		retainedOrder.erase(old->second.order);
+		retained.erase(old);
+	}
+	else {
+		for (unsigned int i = 0; i < k; i++) times[i] = 0;
+	}
+
+	keys[frame] = key;
+	loaded[frame] = true;
+}
+
+PageNum LruKPolicy::selectVictim() {
+	PageNum victim = this->numberOfFrames;
+
+	for (PageNum frame = 0; frame < this->numberOfFrames; frame++) {
+		if (!loaded[frame]) continue;
+
+		if (victim == this->numberOfFrames) {
+			victim = frame;
+			continue;
+		}
+
+		std::atomic<Timestamp>* times = history + frame * k;
+		std::atomic<Timestamp>* victimTimes = history + victim * k;
+
+		//Veca K-ta unazad udaljenost, a za jednake udaljenosti starija poslednja referenca
+		if ((times[k - 1] < victimTimes[k - 1]) || ((times[k - 1] == victimTimes[k - 1]) && (times[0] < victimTimes[0]))) {
+			victim = frame;
+		}
+	}
+
+	return victim;
+}
+
+void LruKPolicy::pageEvicted(PageNum frame) {
+	auto old = retained.find(keys[frame]);
+
+	if (old == retained.end()) {
+		History saved;
+		saved.times = new Timestamp[k];
+		saved.order = retainedOrder.insert(retainedOrder.end(), keys[frame]);
+		old = retained.insert({ keys[frame], saved }).first;
+	}
+
+	for (unsigned int i = 0; i < k; i++) old->second.times[i] = history[frame * k + i];
+
+	if (retained.size() > numberOfFrames) { //Brisanje najstarije sacuvane istorije
+		auto oldest = retained.find(retainedOrder.front());
+		delete[] oldest->second.times;
+		retained.erase(oldest);
+		retainedOrder.pop_front();
+	}
+
+	this->frameFreed(frame);
+}
+
+void LruKPolicy::frameFreed(PageNum frame) {
+	loaded[frame] = false;
+}
+
+bool LruKPolicy::isIdle(PageNum frame) const {
+	return history[frame * k] + numberOfFrames < currentTime; //Od poslednje reference je bilo vise referenci nego sto ima frejmova
+}
@@ -0,0 +1,157 @@
+#include "PageCompressor.h"
+#include <cstdint>
+#include <cstring>
+
+#define MIN_MATCH 4
+#define LENGTH_LIMIT 15
+#define SHORT_COPY 16 //Kratki literali i poklapanja se kopiraju jednim kopiranjem ove duzine ako ima mesta u ulazu i stranici
+
+static bool writeLength(unsigned char* output, size_t& position, size_t limit, size_t length) {
+	for (length -= LENGTH_LIMIT; ; length -= 255) {
+		if (position >= limit) return false;
+
+		output[position++] = (unsigned char)(length < 255 ? length : 255);
+		if (length < 255) return true;
+	}
+}
+
+static bool readLength(const unsigned char* input, size_t& position, size_t size, size_t& length) {
+	while (true) {
+		if (position >= size) return false;
+
+		unsigned char value = input[position++];
+		length += value;
+		if (value < 255) return true;
+	}
+}
+
+//Sekvenca sa matchLength == 0 nema poklapanje i zavrsava stranicu
+static bool writeSequence(unsigned char* output, size_t& position, size_t limit, const unsigned char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+	if (position >= limit) return false;
+
+	size_t matchCode = (matchLength != 0) ? matchLength - MIN_MATCH : 0;
+	output[position++] = (unsigned char)(((literalLength < LENGTH_LIMIT ? literalLength : LENGTH_LIMIT) << 4) | (matchCode < LENGTH_LIMIT ? matchCode : LENGTH_LIMIT));
+
+	if (literalLength >= LENGTH_LIMIT && !writeLength(output, position, limit, literalLength)) return false;
+
+	if (literalLength > limit - position) return false;
+	std::memcpy(output + position, literals, literalLength);
+	position += literalLength;
+
+	if (matchLength == 0) return true;
+
+	if (limit - position < 2) return false;
+	output[position++] = (unsigned char)(offset & 0xFF);
+	output[position++] = (unsigned char)(offset >> 8);
+
+	return matchCode < LENGTH_LIMIT || writeLength(output, position, limit, matchCode);
+}
+
+size_t PageCompressor::compress(const char* page, char* output, size_t limit) {
+	const unsigned char* input = (const unsigned char*)page;
+	unsigned char* out = (unsigned char*)output;
+
+	unsigned short table[1 << PAGE_COMPRESSOR_HASH_BITS]; //Pozicija + 1 poslednja cetiri bajta sa istom hes vrednoscu, 0 ako je nema
+	std::memset(table, 0, sizeof(table));
+
+	size_t position = 0;
+	size_t anchor = 0; //Pocetak literala koji jos nisu upisani
+	size_t written = 0;
+	size_t misses = 0; //Pozicije bez poklapanja od poslednjeg poklapanja, posle svakih 16 se korak pretrage povecava za jedan
+
+	while (position + MIN_MATCH <= PAGE_SIZE) {
+		//Kompresija se prekida kad izlaz, zajedno sa literalima koji nisu upisani, prelazi limit srazmerno obradjenom
+		//delu stranice uz rezervu od osmine limita, jer tada stranica gotovo sigurno nece stati u limit
+		if (written + (position - anchor) > limit * position / PAGE_SIZE + limit / 8) return 0;
+
+		uint32_t sequence;
+		std::memcpy(&sequence, input + position, MIN_MATCH);
+
+		uint32_t hash = (sequence * 2654435761u) >> (32 - PAGE_COMPRESSOR_HASH_BITS);
+		size_t candidate = table[hash];
+		table[hash] = (unsigned short)(position + 1);
+
+		if (candidate == 0 || std::memcmp(input + candidate - 1, input + position, MIN_MATCH) != 0) {
+			position += 1 + (misses++ >> 4); //Stranica koja se ne kompresuje se brzo preskace
+			continue;
+		}
+		candidate--;
+		misses = 0;
+
+		size_t matchLength = MIN_MATCH;
+		while (position + matchLength + sizeof(uint64_t) <= PAGE_SIZE) { //Poredjenje po osam bajtova
+			uint64_t a, b;
+			std::memcpy(&a, input + candidate + matchLength, sizeof(a));
+			std::memcpy(&b, input + position + matchLength, sizeof(b));
+			if (a != b) break;
+			matchLength += sizeof(uint64_t);
+		}
+		while (position + matchLength < PAGE_SIZE && input[candidate + matchLength] == input[position + matchLength]) matchLength++;
+
+		if (!writeSequence(out, written, limit, input + anchor, position - anchor, position - candidate, matchLength)) return 0;
+
+		position += matchLength;
+		anchor = position;
+	}
+
+	if (!writeSequence(out, written, limit, input + anchor, PAGE_SIZE - anchor, 0, 0)) return 0;
+
+	return written;
+}
+
+bool PageCompressor::decompress(const char* input, size_t size, char* page) {
+	const unsigned char* in = (const unsigned char*)input;
+	unsigned char* out = (unsigned char*)page;
+
+	size_t position = 0;
+	size_t written = 0;
+
+	while (true) {
+		if (position >= size) return false; //Ulaz se ne zavrsava sekvencom bez poklapanja, pa je skracen
+
+		unsigned char token = in[position++];
+
+		size_t literalLength = token >> 4;
+		if (literalLength == LENGTH_LIMIT && !readLength(in, position, size, literalLength)) return false;
+
+		if (literalLength > size - position || literalLength > PAGE_SIZE - written) return false;
+		if (literalLength <= SHORT_COPY && SHORT_COPY <= size - position && SHORT_COPY <= PAGE_SIZE - written) {
+			std::memcpy(out + written, in + position, SHORT_COPY);
+		}
+		else {
+			std::memcpy(out + written, in + position, literalLength);
+		}
+		position += literalLength;
+		written += literalLength;
+
+		if (position == size) return written == PAGE_SIZE; //Poslednja sekvenca
+
+		if (size - position < 2) return false;
+		size_t offset = in[position] | (in[position + 1] << 8);
+		position += 2;
+
+		size_t matchLength = token & LENGTH_LIMIT;
+		if (matchLength == LENGTH_LIMIT && !readLength(in, position, size, matchLength)) return false;
+		matchLength += MIN_MATCH;
+
+		if (offset == 0 || offset > written || matchLength > PAGE_SIZE - written) return false;
+
+		if (matchLength <= SHORT_COPY && offset >= SHORT_COPY && SHORT_COPY <= PAGE_SIZE - written) {
+			std::memcpy(out + written, out + written - offset, SHORT_COPY);
+			written += matchLength;
+			continue;
+		}
+
+		//Poklapanje koje se preklapa sa sobom ponavlja poslednjih offset bajtova, pa se kopira u delovima koji se ne preklapaju,
+		//a svaki deo je dva puta duzi od prethodnog
+		const unsigned char* source = out + written - offset;
+		for (size_t copied = 0; copied < matchLength; ) {
+			size_t chunk = written - (source - out);
+			if (chunk > matchLength - copied) chunk = matchLength - copied;
+
+			std::memcpy(out + written, source, chunk);
+			written += chunk;
+			copied += chunk;
+		}
+	}
+}
@@ -1,5 +1,6 @@
 #include "KernelProcess.h"
 #include "KernelSystem.h"
+#include "AccessRecorder.h"
 #include "DummyMutex.h"
 #include "Process.h"
 #include <iostream>
@@ -13,7 +14,9 @@ Process::Process(ProcessId pid) {
 Process::~Process() {
 	//std::cout << "PROCESS " << this->getProcessId() << " FINISHED \n";
 
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
+	if (this->pProcess != nullptr && KernelSystem::kernelSystem != nullptr && KernelSystem::kernelSystem->recorder != nullptr)
+		KernelSystem::kernelSystem->recorder->recordProcess(AccessTraceEvent::DELETE_PROCESS, this->getProcessId());
+
 	if (this->pProcess != nullptr)
 		delete this->pProcess;
 
@@ -23,18 +26,22 @@ ProcessId Process::getProcessId() const {
 	return this->pProcess->getProcessId();
 }
 
-Status Process::createSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags) {
+Status Process::createSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags, bool populate, bool superpages) {
 
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
 	assert(this->pProcess != nullptr);
-	Status status = this->pProcess->createSegment(startAddress, segmentSize, flags);		
+	DummyMutex dummy(this->pProcess->pmtMutex);
+	Status status = this->pProcess->createSegment(startAddress, segmentSize, flags, populate, superpages);		
+	if (KernelSystem::kernelSystem->recorder != nullptr)
+		KernelSystem::kernelSystem->recorder->recordSegment(AccessTraceEvent::CREATE_SEGMENT, this->getProcessId(), startAddress, segmentSize, flags, status, populate, superpages);
 	return status;
 }
 
 Status Process::loadSegment(VirtualAddress startAddress, PageNum segmentSize, AccessType flags, void* content) {
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
 	assert(this->pProcess != nullptr);
+	DummyMutex dummy(this->pProcess->pmtMutex);
 	Status status = this->pProcess->loadSegment(startAddress, segmentSize, flags, content);
+	if (KernelSystem::kernelSystem->recorder != nullptr)
+		KernelSystem::kernelSystem->recorder->recordSegment(AccessTraceEvent::LOAD_SEGMENT, this->getProcessId(), startAddress, segmentSize, flags, status);
 	return status;
 }
 
@@ -42,13 +49,15 @@ Status Process::deleteSegment(VirtualAddress startAddress) {
 
 	assert(this->pProcess != nullptr);
 	Status status = this->pProcess->deleteSegmentLock(startAddress);
+	if (KernelSystem::kernelSystem->recorder != nullptr) KernelSystem::kernelSystem->recorder->recordDeleteSegment(this->getProcessId(), startAddress, status);
 	return status;
 }
 
 Status Process::pageFault(VirtualAddress address) {
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
 	assert(this->pProcess != nullptr);
+	DummyMutex dummy(this->pProcess->pmtMutex);
 	Status status = this->pProcess->pageFault(address);	
+	if (KernelSystem::kernelSystem->recorder != nullptr) KernelSystem::kernelSystem->recorder->recordPageFault(this->getProcessId(), address, status);
 	return status;
 }
 
@@ -59,18 +68,26 @@ PhysicalAddress Process::getPhysicalAddress(VirtualAddress address) {
 }
 
 Status Process::createSharedSegment(VirtualAddress startAddress, PageNum segmentSize, const char * name, AccessType flags) {
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
 	assert(this->pProcess != nullptr);
-	return this->pProcess->createSharedSegment(startAddress, segmentSize, name, flags);
+	DummyMutex sharedDummy(KernelSystem::kernelSystem->sharedSegmentMutex);
+	DummyMutex dummy(this->pProcess->pmtMutex);
+	Status status = this->pProcess->createSharedSegment(startAddress, segmentSize, name, flags);
+	if (KernelSystem::kernelSystem->recorder != nullptr)
+		KernelSystem::kernelSystem->recorder->recordSharedSegment(AccessTraceEvent::CREATE_SHARED_SEGMENT, this->getProcessId(), name, status, startAddress, segmentSize, flags);
+	return status;
 }
 
 Status Process::disconnectSharedSegment(const char * name) {
 	assert(this->pProcess != nullptr);
-	return this->pProcess->disconnectSharedSegmentLock(name);
+	Status status = this->pProcess->disconnectSharedSegmentLock(name);
+	if (KernelSystem::kernelSystem->recorder != nullptr) KernelSystem::kernelSystem->recorder->recordSharedSegment(AccessTraceEvent::DISCONNECT_SHARED_SEGMENT, this->getProcessId(), name, status);
+	return status;
 }
 
 Status Process::deleteSharedSegment(const char * name) {
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
 	assert(this->pProcess != nullptr);
-	return this->pProcess->deleteSharedSegment(name);
+	DummyMutex dummy(KernelSystem::kernelSystem->sharedSegmentMutex); //Tabele procesa koji koriste segment se zakljucavaju pojedinacno
+	Status status = this->pProcess->deleteSharedSegment(name);
+	if (KernelSystem::kernelSystem->recorder != nullptr) KernelSystem::kernelSystem->recorder->recordSharedSegment(AccessTraceEvent::DELETE_SHARED_SEGMENT, this->getProcessId(), name, status);
+	return status;
 }
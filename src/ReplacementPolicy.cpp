@@ -0,0 +1,16 @@
+#include "ReplacementPolicy.h"
+#include "ClockPolicy.h"
+#include "ClockProPolicy.h"
+#include "ArcPolicy.h"
+#include "TwoQueuePolicy.h"
+#include "LruKPolicy.h"
+
+ReplacementPolicy* ReplacementPolicy::create(const SystemConfig& config, PageNum numberOfFrames) {
+	switch (config.replacementPolicy) {
+	case ReplacementPolicyType::CLOCK_PRO: return new ClockProPolicy(numberOfFrames);
+	case ReplacementPolicyType::ARC: return new ArcPolicy(numberOfFrames);
+	case ReplacementPolicyType::TWO_QUEUE: return new TwoQueuePolicy(numberOfFrames);
+	case ReplacementPolicyType::LRU_K: return new LruKPolicy(numberOfFrames, config.lruK);
+	default: return new ClockPolicy(numberOfFrames);
+	}
+}
@@ -5,158 +5,362 @@
 #include <iostream>
 #include "DummyMutex.h"
 #include <mutex>
+#include <initializer_list>
+#include <iterator>
+#include <algorithm>
 size_t SpaceAllocator::pmt1Size = sizeof(PMT1);
 size_t SpaceAllocator::pmt2Size = sizeof(PMT2);
 size_t SpaceAllocator::descSize = sizeof(FreeSpaceDescriptor);
 
 SpaceAllocator::SpaceAllocator(KernelSystem* system, PhysicalAddress pmtSpace, PageNum pmtSpaceSize, PhysicalAddress  processVMspace, PageNum processVMSpaceSize, ClusterNo numberOfClusters, Partition * partition)
-	:mySystem(system), kernelSpaceSize(pmtSpaceSize), pageSpaceSize(processVMSpaceSize), numberOfClusters(numberOfClusters), partition(partition)
+	:mySystem(system), pmtSpace(pmtSpace), processVMSpace(processVMspace), kernelSpaceSize(pmtSpaceSize), pageSpaceSize(processVMSpaceSize), numberOfClusters(numberOfClusters), partition(partition)
 {
-	this->kernelHead = (FreeSpaceDescriptor*)pmtSpace;
-	this->kernelHead->size = pmtSpaceSize * PAGE_SIZE;
-	this->kernelHead->next = nullptr;
+	this->nextFree = new PageNum[processVMSpaceSize];
+	this->prevFree = new PageNum[processVMSpaceSize];
+	this->frameFree = new bool[processVMSpaceSize];
+
+	//Na pocetku su svi frejmovi slobodni, ulancani po rednim brojevima
+	for (PageNum i = 0; i < processVMSpaceSize; i++) {
+		this->nextFree[i] = (i + 1 < processVMSpaceSize) ? i + 1 : NO_FRAME;
+		this->prevFree[i] = (i > 0) ? i - 1 : NO_FRAME;
+		this->frameFree[i] = true;
+	}
 
-	this->pageHead = (FreeSpaceDescriptor*)processVMspace;
-	this->pageHead->size = processVMSpaceSize;
-	this->pageHead->next = nullptr;
+	this->freeHead = (processVMSpaceSize > 0) ? 0 : NO_FRAME;
+	this->freeFrames = processVMSpaceSize;
 
-	this->pageTail = this->pageHead;
-	
-	this->processVMFreeSpace.push_front(FreeSpaceDescriptor(processVMspace, processVMSpaceSize));
 	this->pmtFreeSpace.push_front(FreeSpaceDescriptor(pmtSpace, pmtSpaceSize * PAGE_SIZE));
 
-	this->memoryMutex = new std::mutex();
+	//U mali pmtSpace staje bar PMT_MIN_SLABS manjih slabova, a u slab mora da stane bar jedna tabela prvog nivoa
+	size_t pmt1Pages = (this->getPMTSize(PMTType::LEVEL1_PMT, 0) + PAGE_SIZE - 1) / PAGE_SIZE;
+	this->slabSize = std::min<size_t>(PMT_SLAB_SIZE / PAGE_SIZE, std::max<size_t>(pmtSpaceSize / PMT_MIN_SLABS, pmt1Pages)) * PAGE_SIZE;
+
+	this->slabs.resize(pmtSpaceSize * PAGE_SIZE / this->slabSize);
+	this->pmtSpaceUsed = 0;
+
+	for (PageNum& head : this->partialSlabs) head = NO_SLAB;
 
+	this->memoryMutex = new std::mutex();
+	this->pmtSpaceMutex = new std::mutex();
 }
 
 SpaceAllocator::~SpaceAllocator() {
-
+	delete[] nextFree;
+	delete[] prevFree;
+	delete[] frameFree;
+	delete memoryMutex;
+	delete pmtSpaceMutex;
 }
 
 PhysicalAddress SpaceAllocator::allocatePMT(PMTType type, PageNum segmentSize) {
 
-	size_t size;
+	size_t size = this->getPMTSize(type, segmentSize);
 
-	if (type == PMTType::LEVEL1_PMT) size = SpaceAllocator::pmt1Size;
-	else if (type == PMTType::LEVEL2_PMT) size = SpaceAllocator::pmt2Size;
-	else size = segmentSize * sizeof(Descriptor);
+	DummyMutex dummy(this->pmtSpaceMutex);
 
-	if (pmtFreeSpace.empty()) return nullptr;
+	if (type == PMTType::SHARED_SEG_PMT) {
+		PhysicalAddress pmtAdr = this->takeRegion(size);
 
-	std::list<FreeSpaceDescriptor>::iterator it;
+		if ((pmtAdr == nullptr) && this->releaseEmptySlabs()) pmtAdr = this->takeRegion(size);
 
-	for (it = pmtFreeSpace.begin(); (it != pmtFreeSpace.end()) && (it->size < size); ++it);
+		if (pmtAdr != nullptr) this->pmtSpaceUsed += size;
 
-	if (it == pmtFreeSpace.end()) return nullptr;
+		return pmtAdr;
+	}
 
-	size_t newSize = it->size - size;
-	PhysicalAddress pmtAdr = it->space;
+	PageNum index = this->partialSlabs[type];
 
-	if (newSize > 0) {
+	if (index == NO_SLAB) { //Nijedan slab ovog tipa nema slobodnu tabelu
+		index = this->addSlab(type);
 
-		it->space = (char*)pmtAdr + size;
-		it->size = newSize;
+		if ((index == NO_SLAB) && this->releaseEmptySlabs()) index = this->addSlab(type);
 
+		if (index == NO_SLAB) { //Ceo slab ne staje, npr. u mali pmtSpace, pa se tabela uzima van slabova
+			PhysicalAddress pmtAdr = this->takeRegion(size);
+
+			if (pmtAdr != nullptr) this->pmtSpaceUsed += size;
+
+			return pmtAdr;
+		}
 	}
-	else {
-		pmtFreeSpace.remove(*it);
-	}
+
+	Slab& slab = this->slabs[index];
+
+	PhysicalAddress pmtAdr = slab.freeList;
+
+	slab.freeList = *(void**)pmtAdr;
+	++slab.used;
+
+	if (slab.freeList == nullptr) this->unlinkSlab(type, index); //Slab je pun
+
+	this->pmtSpaceUsed += size;
+
 	return pmtAdr;
 }
 
 void SpaceAllocator::deallocatePMT(PhysicalAddress adr, PMTType type, PageNum segmentSize) {
-	size_t size;
+	DummyMutex dummy(this->pmtSpaceMutex);
 
-	if (type == PMTType::LEVEL1_PMT) size = SpaceAllocator::pmt1Size;
-	else if (type == PMTType::LEVEL2_PMT) size = SpaceAllocator::pmt2Size;
-	else size = segmentSize * sizeof(Descriptor);
+	size_t size = this->getPMTSize(type, segmentSize);
+	this->pmtSpaceUsed -= size;
+
+	if (type == PMTType::SHARED_SEG_PMT) {
+		this->releaseRegion(adr, size);
+		return;
+	}
 
-	FreeSpaceDescriptor newDesc(adr, size);
+	PageNum index = ((char*)adr - (char*)this->pmtSpace) / this->slabSize;
 
-	if (this->pmtFreeSpace.empty()) {
-		this->pmtFreeSpace.push_front(newDesc);
+	//Slab sa dodeljenom tabelom ima bar jednu dodeljenu tabelu, inace je tabela uzeta van slabova
+	if ((index >= this->slabs.size()) || (this->slabs[index].used == 0)) {
+		this->releaseRegion(adr, size);
+		return;
 	}
 
-	else {
-		std::list<FreeSpaceDescriptor>::iterator it, begin, end;
+	Slab& slab = this->slabs[index];
 
-		begin = pmtFreeSpace.begin();
-		end = pmtFreeSpace.end();
+	if (slab.freeList == nullptr) { //Slab je bio pun, vraca se u listu slabova sa slobodnim tabelama
+		slab.prev = NO_SLAB;
+		slab.next = this->partialSlabs[type];
 
-		for (it = begin; (it != end); ++it) {
-			if ((it->space > adr)) break;
-		}
+		if (slab.next != NO_SLAB) this->slabs[slab.next].prev = index;
+		this->partialSlabs[type] = index;
+	}
+
+	*(void**)adr = slab.freeList;
+	slab.freeList = adr;
+	--slab.used; //Prazan slab ostaje u listi dok prostor ne zatreba drugom tipu tabele
+}
+
+PageNum SpaceAllocator::addSlab(PMTType type) {
+	PhysicalAddress slabAdr = nullptr;
+
+	//Prvi slobodan deo u koji staje ceo slab poravnat na velicinu slaba od pocetka pmtSpace-a
+	for (auto it = this->pmtFreeSpace.begin(); it != this->pmtFreeSpace.end(); ++it) {
+		size_t offset = (char*)it->space - (char*)this->pmtSpace;
+		size_t aligned = (offset + this->slabSize - 1) / this->slabSize * this->slabSize;
+
+		if (aligned + this->slabSize > offset + it->size) continue;
 
-		if (it == pmtFreeSpace.begin() && it->space < pmtFreeSpace.begin()->space) this->pmtFreeSpace.push_front(newDesc);
+		slabAdr = (char*)this->pmtSpace + aligned;
 
-		else if (it == pmtFreeSpace.end()) {
-			auto it2 = --it;
-			if (adr > it2->space)
-				this->pmtFreeSpace.push_back(newDesc);
+		//Iz slobodnog dela ostaju delovi ispred i iza slaba
+		size_t after = offset + it->size - (aligned + this->slabSize);
+
+		if (after > 0) {
+			this->pmtFreeSpace.insert(std::next(it), FreeSpaceDescriptor((char*)slabAdr + this->slabSize, after));
 		}
 
-		else {
-			if (it != pmtFreeSpace.begin()) --it;
-			this->pmtFreeSpace.insert(it, newDesc);
+		if (aligned > offset) it->size = aligned - offset;
+		else this->pmtFreeSpace.erase(it);
+
+		break;
+	}
+
+	if (slabAdr == nullptr) return NO_SLAB;
+
+	PageNum index = ((char*)slabAdr - (char*)this->pmtSpace) / this->slabSize;
+	size_t size = this->getPMTSize(type, 0);
+	size_t count = this->slabSize / size;
+
+	//Ulancavanje svih tabela slaba u listu slobodnih
+	for (size_t i = 0; i < count; i++) {
+		*(void**)((char*)slabAdr + i * size) = (i + 1 < count) ? (char*)slabAdr + (i + 1) * size : nullptr;
+	}
+
+	Slab& slab = this->slabs[index];
+
+	slab.freeList = slabAdr;
+	slab.used = 0;
+	slab.prev = NO_SLAB;
+	slab.next = this->partialSlabs[type];
+
+	if (slab.next != NO_SLAB) this->slabs[slab.next].prev = index;
+	this->partialSlabs[type] = index;
+
+	return index;
+}
+
+void SpaceAllocator::unlinkSlab(PMTType type, PageNum index) {
+	Slab& slab = this->slabs[index];
+
+	if (slab.prev != NO_SLAB) this->slabs[slab.prev].next = slab.next;
+	else this->partialSlabs[type] = slab.next;
+
+	if (slab.next != NO_SLAB) this->slabs[slab.next].prev = slab.prev;
+
+	slab.next = slab.prev = NO_SLAB;
+}
+
+bool SpaceAllocator::releaseEmptySlabs() {
+	bool released = false;
+
+	for (PMTType type : { PMTType::LEVEL1_PMT, PMTType::LEVEL2_PMT, PMTType::COW_DESCRIPTOR }) {
+		PageNum index = this->partialSlabs[type];
+
+		while (index != NO_SLAB) {
+			PageNum next = this->slabs[index].next;
+
+			if (this->slabs[index].used == 0) {
+				this->unlinkSlab(type, index);
+				this->slabs[index].freeList = nullptr;
+				this->releaseRegion((char*)this->pmtSpace + index * this->slabSize, this->slabSize);
+				released = true;
+			}
+
+			index = next;
 		}
 	}
+
+	return released;
 }
 
-PhysicalAddress SpaceAllocator::allocatePage() throw(MemoryException) {
-	//DummyMutex dummy(this->memoryMutex);
+PhysicalAddress SpaceAllocator::takeRegion(size_t size) {
+	for (auto it = this->pmtFreeSpace.rbegin(); it != this->pmtFreeSpace.rend(); ++it) {
+		if (it->size < size) continue;
+
+		it->size -= size;
+		PhysicalAddress adr = (char*)it->space + it->size;
 
-	if (this->processVMFreeSpace.empty()) {
-		PhysicalAddress adr = this->mySystem->swapPage();
+		if (it->size == 0) this->pmtFreeSpace.erase(std::next(it).base());
 
-		this->processVMFreeSpace.push_front(FreeSpaceDescriptor(adr, 1));
+		return adr;
 	}
 
-	FreeSpaceDescriptor& desc = this->processVMFreeSpace.front(); //Uzimanje reference na prvi element u listi
+	return nullptr;
+}
+
+void SpaceAllocator::releaseRegion(PhysicalAddress adr, size_t size) {
+	auto next = this->pmtFreeSpace.begin();
+
+	while ((next != this->pmtFreeSpace.end()) && (next->space < adr)) ++next;
 
-	PhysicalAddress pageAdr = desc.space;
+	if (next != this->pmtFreeSpace.begin()) { //Spajanje sa prethodnim slobodnim delom
+		auto prev = std::prev(next);
 
-	if (desc.size > 1) {
-		desc.space = (PhysicalAddress)((char*)desc.space + PAGE_SIZE);
-		--desc.size;
+		if ((char*)prev->space + prev->size == (char*)adr) {
+			prev->size += size;
+
+			if ((next != this->pmtFreeSpace.end()) && ((char*)adr + size == (char*)next->space)) {
+				prev->size += next->size;
+				this->pmtFreeSpace.erase(next);
+			}
+
+			return;
+		}
 	}
 
-	else {
-		this->processVMFreeSpace.pop_front();
+	if ((next != this->pmtFreeSpace.end()) && ((char*)adr + size == (char*)next->space)) { //Spajanje sa sledecim slobodnim delom
+		next->space = adr;
+		next->size += size;
+		return;
 	}
-	
-	return pageAdr;
+
+	this->pmtFreeSpace.insert(next, FreeSpaceDescriptor(adr, size));
 }
+size_t SpaceAllocator::getPMTSize(PMTType type, PageNum segmentSize) const {
+	size_t size;
 
-void SpaceAllocator::deallocatePage(PhysicalAddress page) {
-	//DummyMutex dummy(this->memoryMutex);
+	if (type == PMTType::LEVEL1_PMT) size = SpaceAllocator::pmt1Size;
+	else if (type == PMTType::LEVEL2_PMT) size = SpaceAllocator::pmt2Size;
+	else if (type == PMTType::COW_DESCRIPTOR) { //Deskriptor postoji za svaku stranicu koja se deli sa klonom, pa se ne zaokruzuje na kes liniju
+		return (sizeof(CowDescriptor) + COW_DESCRIPTOR_SLOT_SIZE - 1) / COW_DESCRIPTOR_SLOT_SIZE * COW_DESCRIPTOR_SLOT_SIZE;
+	}
+	else size = segmentSize * sizeof(Descriptor);
 
-	FreeSpaceDescriptor newDesc(page, 1);
+	//Velicine se zaokruzuju na cele kes linije, pa svaka tabela pocinje na pocetku kes linije ako je pmtSpace poravnat
+	return (size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
 
-	if (this->processVMFreeSpace.empty()) {
-		this->processVMFreeSpace.push_front(newDesc);
+PhysicalAddress SpaceAllocator::allocatePage() {
+	{
+		DummyMutex dummy(this->memoryMutex);
+
+		if (this->freeHead != NO_FRAME) {
+			return this->takeFreePage();
+		}
 	}
 
-	else {
-		std::list<FreeSpaceDescriptor>::iterator it, begin, end;
+	return this->mySystem->swapPage(); //Izbacivanje se radi bez memoryMutex-a, frejm izbacene stranice se odmah dodeljuje
+}
 
-		begin = processVMFreeSpace.begin();
-		end = processVMFreeSpace.end();
+PhysicalAddress SpaceAllocator::allocateFreePage() {
+	DummyMutex dummy(this->memoryMutex);
 
-		for (it = begin; (it != end); ++it) { 
-			if ((it->space > page)) break;
-		}
+	if (this->freeHead == NO_FRAME) return nullptr;
 
-		if (it == processVMFreeSpace.begin() && it->space < processVMFreeSpace.begin()->space) this->processVMFreeSpace.push_front(newDesc);
+	return this->takeFreePage();
+}
 
-		else if (it == processVMFreeSpace.end()) {
-			auto it2 = --it;
-			if (page > it2->space)
-				this->processVMFreeSpace.push_back(newDesc);
-		}
+PhysicalAddress SpaceAllocator::takeFreePage() {
+	PageNum frame = this->freeHead;
+
+	this->unlinkFreeFrame(frame);
+
+	return (char*)this->processVMSpace + frame * PAGE_SIZE;
+}
 
-		else {
-			if (it != processVMFreeSpace.begin()) --it;
-			this->processVMFreeSpace.insert(it, newDesc);
+PhysicalAddress SpaceAllocator::allocateContiguous(PageNum count) {
+	DummyMutex dummy(this->memoryMutex);
+
+	return this->takeRun(count, 1);
+}
+
+PhysicalAddress SpaceAllocator::allocateAlignedRun(PageNum count) {
+	DummyMutex dummy(this->memoryMutex);
+
+	return this->takeRun(count, count);
+}
+
+PhysicalAddress SpaceAllocator::takeRun(PageNum count, PageNum alignment) {
+	PageNum start = 0; //Prvi poravnat frejm od kog su svi frejmovi do trenutnog slobodni
+
+	for (PageNum frame = 0; frame < this->pageSpaceSize; frame++) {
+		if (!this->frameFree[frame]) {
+			start = (frame + alignment) / alignment * alignment;
+			continue;
 		}
+
+		if ((frame < start) || (frame + 1 - start < count)) continue;
+
+		for (PageNum i = start; i <= frame; i++) this->unlinkFreeFrame(i);
+
+		return (char*)this->processVMSpace + start * PAGE_SIZE;
+	}
+
+	return nullptr;
+}
+
+void SpaceAllocator::deallocatePage(PhysicalAddress page) {
+	this->deallocatePages(page, 1);
+}
+
+void SpaceAllocator::deallocatePages(PhysicalAddress page, PageNum count) {
+	PageNum first = ((char*)page - (char*)this->processVMSpace) / PAGE_SIZE;
+
+	DummyMutex dummy(this->memoryMutex);
+
+	//Frejmovi se stavljaju na pocetak liste od poslednjeg, pa ce prvi frejm niza biti prvi sledeci dodeljen
+	for (PageNum i = count; i > 0; i--) {
+		PageNum frame = first + i - 1;
+
+		this->frameFree[frame] = true;
+		this->prevFree[frame] = NO_FRAME;
+		this->nextFree[frame] = this->freeHead;
+
+		if (this->freeHead != NO_FRAME) this->prevFree[this->freeHead] = frame;
+		this->freeHead = frame;
 	}
+
+	this->freeFrames += count;
+}
+
+void SpaceAllocator::unlinkFreeFrame(PageNum frame) {
+	if (this->prevFree[frame] != NO_FRAME) this->nextFree[this->prevFree[frame]] = this->nextFree[frame];
+	else this->freeHead = this->nextFree[frame];
+
+	if (this->nextFree[frame] != NO_FRAME) this->prevFree[this->nextFree[frame]] = this->prevFree[frame];
+
+	this->frameFree[frame] = false;
+	--this->freeFrames;
 }
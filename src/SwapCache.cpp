@@ -0,0 +1,162 @@
+#include "SwapCache.h"
+#include "KernelSystem.h"
+#include "PageCompressor.h"
+#include "DummyMutex.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cstring>
+
+SwapCache::SwapCache(KernelSystem* system, size_t capacity, PageNum writebackBatch)
+		: system(system), capacity(capacity), writebackBatch(writebackBatch), used(0) {
+	this->mutex = new std::mutex();
+}
+
+SwapCache::~SwapCache() {
+	for (auto& it : entries) delete[] it.second.data;
+
+	delete mutex;
+}
+
+bool SwapCache::write(const std::vector<std::pair<ClusterNo, const char*>>& pages) {
+	//Stranice se kompresuju pre zakljucavanja, pa citanje iz kesa ne ceka na kompresiju
+	std::vector<Entry> compressed(pages.size());
+	std::vector<std::pair<ClusterNo, const char*>> uncompressed;
+	char buffer[SWAP_CACHE_MAX_COMPRESSED_SIZE];
+
+	for (size_t i = 0; i < pages.size(); i++) {
+		size_t size = PageCompressor::compress(pages[i].second, buffer, SWAP_CACHE_MAX_COMPRESSED_SIZE);
+
+		if (size == 0) {
+			uncompressed.push_back(pages[i]);
+			continue;
+		}
+
+		compressed[i].data = new char[size];
+		compressed[i].size = size;
+		std::memcpy(compressed[i].data, buffer, size);
+	}
+
+	DummyMutex dummy(this->mutex);
+
+	for (size_t i = 0; i < pages.size(); i++) {
+		auto it = entries.find(pages[i].first);
+		if (it != entries.end()) this->erase(it); //Stara stranica klastera, nova je u kesu ili ce biti upisana na disk
+
+		if (compressed[i].data == nullptr) continue;
+
+		lru.push_front(pages[i].first);
+		compressed[i].lru = lru.begin();
+		entries.insert({ pages[i].first, compressed[i] });
+
+		used += compressed[i].size;
+	}
+
+	stats.stores += pages.size() - uncompressed.size();
+	stats.rejected += uncompressed.size();
+
+	//Stranica koja nije u kesu mora biti na disku pre nego sto se zakljucavanje kesa otpusti
+	bool written = this->system->writePartitionRuns(uncompressed);
+
+	if (used > capacity) this->shrink();
+
+	return written;
+}
+
+bool SwapCache::read(ClusterNo first, ClusterNo count, char* const* buffers, ClusterNo& diskReads) {
+	std::vector<bool> cached(count, false);
+	diskReads = 0;
+
+	{
+		DummyMutex dummy(this->mutex);
+
+		for (ClusterNo i = 0; i < count; i++) {
+			auto it = entries.find(first + i);
+
+			if (it == entries.end()) {
+				++diskReads;
+				continue;
+			}
+
+			if (!PageCompressor::decompress(it->second.data, it->second.size, buffers[i])) return false;
+
+			lru.splice(lru.begin(), lru, it->second.lru);
+			cached[i] = true;
+		}
+
+		stats.hits += count - diskReads;
+		stats.misses += diskReads;
+	}
+
+	//Klaster kog nema u kesu ne moze da se upise dok se njegova stranica cita, pa se disk cita bez zakljucavanja
+	for (ClusterNo i = 0, run; i < count; i += run) {
+		for (run = 1; i + run < count && cached[i + run] == cached[i]; run++);
+
+		if (!cached[i] && !this->system->partition->readClusters(first + i, run, buffers + i)) return false;
+	}
+
+	return true;
+}
+
+void SwapCache::invalidate(ClusterNo cluster) {
+	DummyMutex dummy(this->mutex);
+
+	auto it = entries.find(cluster);
+	if (it != entries.end()) this->erase(it);
+}
+
+SwapCacheStats SwapCache::getStats() {
+	DummyMutex dummy(this->mutex);
+
+	SwapCacheStats result = stats;
+	result.pages = entries.size();
+	result.bytes = used;
+	result.capacity = capacity;
+
+	return result;
+}
+
+void SwapCache::erase(std::unordered_map<ClusterNo, Entry>::iterator entry) {
+	used -= entry->second.size;
+	lru.erase(entry->second.lru);
+	delete[] entry->second.data;
+	entries.erase(entry);
+}
+
+void SwapCache::shrink() {
+	std::vector<ClusterNo> victims;
+	size_t freed = 0;
+
+	for (auto it = lru.rbegin(); it != lru.rend() && (used - freed > capacity || victims.size() < writebackBatch); ++it) {
+		victims.push_back(*it);
+		freed += entries[*it].size;
+	}
+
+	std::sort(victims.begin(), victims.end());
+
+	char* buffer = new char[victims.size() * PAGE_SIZE];
+	std::vector<std::pair<ClusterNo, const char*>> pages;
+
+	for (size_t i = 0; i < victims.size(); i++) {
+		const Entry& entry = entries[victims[i]];
+
+		//Neispravna stranica bi pokvarila sadrzaj klastera, pa ostaje u kesu
+		if (!PageCompressor::decompress(entry.data, entry.size, buffer + i * PAGE_SIZE)) {
+			TRACE_ERROR(SWAP_CACHE_DECOMPRESS_FAILED, 0, victims[i]);
+			continue;
+		}
+
+		pages.push_back({ victims[i], buffer + i * PAGE_SIZE });
+	}
+
+	//Stranice se brisu iz kesa tek posle upisa, pa citanje klastera koji se upisuje ceka na zakljucavanje kesa
+	if (this->system->writePartitionRuns(pages)) {
+		for (auto& page : pages) this->erase(entries.find(page.first));
+
+		stats.writebacks += pages.size();
+	}
+	else { //Kes ostaje veci od zadate velicine, upis se ponovo pokusava pri sledecem upisu u kes
+		TRACE_ERROR(SWAP_CACHE_WRITE_FAILED, 0, pages.size());
+	}
+
+	delete[] buffer;
+}
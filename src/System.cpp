@@ -1,10 +1,16 @@
 #include "System.h"
 #include "DummyMutex.h"
 #include "KernelSystem.h"
+#include "AccessRecorder.h"
+#include "Process.h"
 #include <mutex>
 
-System::System(PhysicalAddress processVMSpace, PageNum processVMSpaceSize, PhysicalAddress pmtSpace, PageNum pmtSpaceSize, Partition * partition) {
-	this->pSystem = new KernelSystem(processVMSpace, processVMSpaceSize, pmtSpace, pmtSpaceSize, partition, this);
+System::System(PhysicalAddress processVMSpace, PageNum processVMSpaceSize, PhysicalAddress pmtSpace, PageNum pmtSpaceSize, Partition * partition) 
+	: System(processVMSpace, processVMSpaceSize, pmtSpace, pmtSpaceSize, partition, SystemConfig()) {
+}
+
+System::System(PhysicalAddress processVMSpace, PageNum processVMSpaceSize, PhysicalAddress pmtSpace, PageNum pmtSpaceSize, Partition * partition, const SystemConfig& config) {
+	this->pSystem = new KernelSystem(processVMSpace, processVMSpaceSize, pmtSpace, pmtSpaceSize, partition, this, config);
 }
 
 System::~System() {
@@ -12,22 +18,72 @@ System::~System() {
 }
 
 Process* System::createProcess() {
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
 	Process* proc = this->pSystem->createProcess();
+	if (this->pSystem->recorder != nullptr) this->pSystem->recorder->recordProcess(AccessTraceEvent::CREATE_PROCESS, proc->getProcessId());
 	return proc;
 }
 
 Time System::periodicJob() {
+	if (this->pSystem->recorder != nullptr) this->pSystem->recorder->recordPeriodicJob();
 	return this->pSystem->periodicJob();
 }
 
 Status System::access(ProcessId pid, VirtualAddress address, AccessType type) {
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
-	return this->pSystem->access(pid, address, type);
+	Status status = this->pSystem->access(pid, address, type);
+	if (this->pSystem->recorder != nullptr) this->pSystem->recorder->recordAccess(pid, address, type, status);
+	return status;
+}
+
+Status System::accessBatch(ProcessId pid, const AccessRequest* requests, PageNum count, AccessResult* results) {
+	Status status = this->pSystem->accessBatch(pid, requests, count, results);
+	if (this->pSystem->recorder != nullptr) this->pSystem->recorder->recordAccessBatch(pid, requests, count, status);
+	return status;
 }
 
 Process * System::cloneProcess(ProcessId pid) {
-	DummyMutex dummy(KernelSystem::kernelSystem->globalMutex);
+	Process* clone = this->pSystem->cloneProcess(pid);
+	if (this->pSystem->recorder != nullptr) this->pSystem->recorder->recordClone(pid, (clone != nullptr) ? clone->getProcessId() : 0);
+	return clone;
+}
+
+bool System::startRecording(const char* fileName) {
+	if (this->pSystem->recorder != nullptr) return false;
+
+	AccessRecorder* recorder = new AccessRecorder();
+	if (!recorder->open(fileName)) {
+		delete recorder;
+		return false;
+	}
+
+	this->pSystem->recorder = recorder;
+	return true;
+}
 
-	return this->pSystem->cloneProcess(pid);
+bool System::stopRecording() {
+	AccessRecorder* recorder = this->pSystem->recorder;
+	if (recorder == nullptr) return false;
+
+	this->pSystem->recorder = nullptr;
+	bool written = recorder->close();
+	delete recorder;
+	return written;
+}
+
+
+WritebackStats System::getWritebackStats() {
+	DummyMutex dummy(KernelSystem::kernelSystem->evictionMutex); //Brojaci se menjaju pri izbacivanju i upisu u pozadini
+
+	return this->pSystem->writebackStats;
 }
+
+PrefetchStats System::getPrefetchStats() {
+	DummyMutex dummy(KernelSystem::kernelSystem->evictionMutex);
+
+	PrefetchStats stats = this->pSystem->prefetchStats;
+	stats.hits = this->pSystem->prefetchHits;
+	return stats;
+}
+
+SystemStats System::getStats() {
+	return this->pSystem->getStats();
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+//Bafer se pravi pri prvom dogadjaju niti i ostaje do kraja programa, da bi dump video i dogadjaje zavrsenih niti
+static thread_local TraceBuffer* threadBuffer = nullptr;
+
+static TraceBuffer* buffers = nullptr; //Lista bafera svih niti
+static unsigned short threads = 0;
+static std::mutex buffersMutex; //Stiti listu bafera, dogadjaji se upisuju bez zakljucavanja
+
+static const TraceEventInfo eventInfo[(int)TraceEvent::EVENT_COUNT] = {
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda createSegment | Nema memorije za stranice segmenta.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda loadSegment | Greska pri upisu segmenta na disk.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda loadSegment | Nema memorije za stranice segmenta.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda deleteSegment | Pocetna adresa nije poravnata na pocetak segmenta.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda deleteSegment | Prosledjena adresa nije pocetak segmenta.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda deleteSegment | Prosledjena adresa nije adresa prve stranice u segmentu.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda deleteSegment | Pokusaj brisanja deljenog segmenta.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda pageFault | Nema frejma za stranicu.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: Metoda allocatePMT1 | Nema dovoljno prostora za alociranje PMTa.", { nullptr, nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: Metoda createSuperpage | U odgovarajucem deskriptoru prosledjene adrese je vec alocirana stranica.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: Metoda splitSuperpage | Nema dovoljno prostora za alociranje PMTa.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda copyOnWrite | Nema frejma za kopiju stranice.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: Metoda GetPhysicalAddress | Nedozvoljeno preslikavanje, program se prekida.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda createSharedSegment | Nema memorije za stranice segmenta.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: Metoda createSharedSegment | Pokusaj da se doda vec kreiran segment u memorijski prostor, velicine segmenata nekompatibilne.", { "adresa", "velicina" } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: Metoda createSharedSegment | Pokusaj da se doda vec kreiran segment u memorijski prostor, prava pristupa nekompatibilna.", { "adresa", "prava" } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda disconnectSharedSegment | Deljeni segment sa zadatim imenom ne postoji.", { nullptr, nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda disconnectSharedSegment | Proces ne koristi segment sa zadatim imenom.", { nullptr, nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda disconnectSharedSegment | Greska u PM tabeli procesa.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda deleteSharedSegment | Deljeni segment sa zadatim imenom ne postoji.", { nullptr, nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda checkSegment | Pocetna adresa nije poravnata na pocetak segmenta.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda checkSegment | Segment izvan granica virtuelne memorije.", { "adresa", "velicina" } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda checkSegment | Segment ne moze biti velicine 0.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda checkSegment | Segment se preklapa sa vec alociranim segmentom.", { "adresa", "velicina" } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: Metoda updatePMT | U odgovarajucem deskriptoru prosledjene adrese je vec alocirana stranica.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: Metoda updatePMT | Nema dovoljno prostora za alociranje PMTa.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda writeBack | Greska pri upisu stranice na klaster.", { "stranice", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda cloneProcess | Ne postoji proces sa prosledjenim ID-jem.", { nullptr, nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda cloneProcess | Nema dovoljno prostora za tabele drugog nivoa klona.", { nullptr, nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda cloneProcess | Nema dovoljno prostora za deskriptor zajednicke stranice.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda SwapCache::shrink | Greska pri upisu stranica iz kesa na disk, stranice ostaju u kesu.", { "stranice", nullptr } },
+	{ TRACE_LEVEL_ERROR, "GRESKA: metoda SwapCache::shrink | Stranica u kesu nije ispravno kompresovana, ne upisuje se na disk i ostaje u kesu.", { "klaster", nullptr } },
+
+	{ TRACE_LEVEL_INFO, "Metoda Access | Status = TRAP | pcb == nullptr", { nullptr, nullptr } },
+	{ TRACE_LEVEL_INFO, "Metoda Access | Status = TRAP | pmtHead == nullptr", { "adresa", nullptr } },
+	{ TRACE_LEVEL_INFO, "Metoda Access | Status = PAGE_FAULT | pmt2 == nullptr", { "adresa", nullptr } },
+	{ TRACE_LEVEL_INFO, "Metoda Access | Trazena stranica nije dodeljena procesu.", { "adresa", nullptr } },
+	{ TRACE_LEVEL_INFO, "Metoda Access | Status = TRAP | Nema trazeno pravo pristupa", { "adresa", "tip" } },
+	{ TRACE_LEVEL_INFO, "Metoda AccessBatch | Status = TRAP | pcb == nullptr", { "adrese", nullptr } },
+	{ TRACE_LEVEL_INFO, "Metoda pageFault | Trazena stranica nije bila ucitana metodom create ili load segment.", { "adresa", nullptr } },
+
+	{ TRACE_LEVEL_DEBUG, "Metoda Access | Status = PAGE_FAULT", { "adresa", nullptr } },
+	{ TRACE_LEVEL_DEBUG, "Metoda PageFault | Citanje stranice sa diska.", { "adresa", "klaster" } },
+	{ TRACE_LEVEL_DEBUG, "Metoda PageFault | Vracena stranica sa diska", { "adresa", "frejm" } },
+};
+
+void Trace::record(TraceEvent event, ProcessId pid, unsigned long long arg0, unsigned long long arg1) {
+	TraceBuffer* buffer = threadBuffer;
+
+	if (buffer == nullptr) buffer = Trace::addBuffer();
+
+	TraceRecord record;
+	unsigned long long words[TRACE_RECORD_WORDS];
+
+	record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	record.args[0] = arg0;
+	record.args[1] = arg1;
+	record.pid = pid;
+	record.event = event;
+	record.thread = buffer->thread;
+	std::memcpy(words, &record, sizeof(record));
+
+	unsigned long long head = buffer->head.load(std::memory_order_relaxed);
+	std::atomic<unsigned long long>* slot = buffer->records[head % TRACE_BUFFER_SIZE];
+
+	//Ako dump procita bilo koju rec novog dogadjaja, posle ograde u dump-u vidi i head koji pokazuje da je mesto prepisano
+	std::atomic_thread_fence(std::memory_order_release);
+	for (size_t i = 0; i < TRACE_RECORD_WORDS; i++) slot[i].store(words[i], std::memory_order_relaxed);
+
+	buffer->head.store(head + 1, std::memory_order_release); //dump cita samo dogadjaje pre head
+}
+
+TraceBuffer* Trace::addBuffer() {
+	TraceBuffer* buffer = new TraceBuffer();
+	buffer->head = 0;
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+
+	buffer->thread = ++threads;
+	buffer->next = buffers;
+	buffers = buffer;
+
+	threadBuffer = buffer;
+	return buffer;
+}
+
+bool Trace::dump(const char* fileName) {
+	std::vector<TraceRecord> records;
+	TraceFileHeader header;
+
+	std::memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic));
+	header.recordSize = sizeof(TraceRecord);
+	header.lost = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+
+		header.threads = threads;
+
+		for (TraceBuffer* buffer = buffers; buffer != nullptr; buffer = buffer->next) {
+			unsigned long long head = buffer->head.load(std::memory_order_acquire);
+			unsigned long long first = (head > TRACE_BUFFER_SIZE) ? head - TRACE_BUFFER_SIZE : 0;
+
+			size_t start = records.size();
+			for (unsigned long long i = first; i < head; i++) {
+				std::atomic<unsigned long long>* slot = buffer->records[i % TRACE_BUFFER_SIZE];
+				unsigned long long words[TRACE_RECORD_WORDS];
+				TraceRecord record;
+
+				for (size_t j = 0; j < TRACE_RECORD_WORDS; j++) words[j] = slot[j].load(std::memory_order_relaxed);
+				std::memcpy(&record, words, sizeof(record));
+				records.push_back(record);
+			}
+
+			//Nit je tokom kopiranja mogla da prepise najstarije kopirane dogadjaje, a dogadjaj na mestu head je mozda upisan do pola.
+			//Ograda obezbedjuje da head procitan posle nje pokriva svaki dogadjaj cija je rec procitana u kopiji.
+			std::atomic_thread_fence(std::memory_order_acquire);
+			unsigned long long after = buffer->head.load(std::memory_order_relaxed);
+			unsigned long long valid = (after + 1 > TRACE_BUFFER_SIZE) ? after + 1 - TRACE_BUFFER_SIZE : 0;
+
+			if (valid > first) {
+				unsigned long long dropped = std::min(valid, head) - first;
+				records.erase(records.begin() + start, records.begin() + start + dropped);
+				first += dropped;
+			}
+
+			header.lost += first;
+		}
+	}
+
+	std::sort(records.begin(), records.end(), [](const TraceRecord& a, const TraceRecord& b) { return a.time < b.time; });
+	header.records = records.size();
+
+	FILE* file = std::fopen(fileName, "wb");
+	if (file == nullptr) return false;
+
+	bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+	if (written && !records.empty()) written = std::fwrite(records.data(), sizeof(TraceRecord), records.size(), file) == records.size();
+
+	return (std::fclose(file) == 0) && written;
+}
+
+const TraceEventInfo& Trace::getEventInfo(TraceEvent event) {
+	return eventInfo[(int)event];
+}
@@ -0,0 +1,93 @@
+#include "TwoQueuePolicy.h"
+
+TwoQueuePolicy::TwoQueuePolicy(PageNum numberOfFrames) : numberOfFrames(numberOfFrames) {
+	this->entries = new std::list<PageNum>::iterator[numberOfFrames];
+	this->queue = new QueueType[numberOfFrames];
+	this->keys = new PageKey[numberOfFrames]{ 0 };
+	this->referenced = new std::atomic<bool>[numberOfFrames]();
+
+	for (PageNum i = 0; i < numberOfFrames; i++) queue[i] = QueueType::NONE;
+
+	//Velicine redova koje preporucuju autori: A1in 25% memorije, A1out kljucevi za 50% memorije
+	this->inLimit = numberOfFrames / 4 > 0 ? numberOfFrames / 4 : 1;
+	this->outLimit = numberOfFrames / 2 > 0 ? numberOfFrames / 2 : 1;
+}
+
+TwoQueuePolicy::~TwoQueuePolicy() {
+	delete[] entries;
+	delete[] queue;
+	delete[] keys;
+	delete[] referenced;
+}
+
+void TwoQueuePolicy::pageAccessed(PageNum frame) {
+	referenced[frame].store(true, std::memory_order_relaxed);
+}
+
+void TwoQueuePolicy::pageLoaded(PageNum frame, PageKey key) {
+	auto ghost = a1outMap.find(key);
+
+	keys[frame] = key;
+	referenced[frame] = false;
+
+	if (ghost != a1outMap.end()) { //Stranica je trazena dok je bila u A1out, prelazi u Am
+		a1out.erase(ghost->second);
+		a1outMap.erase(ghost);
+
+		entries[frame] = am.insert(am.end(), frame);
+		queue[frame] = QueueType::AM;
+	}
+	else {
+		entries[frame] = a1in.insert(a1in.end(), frame);
+		queue[frame] = QueueType::A1_IN;
+	}
+}
+
+PageNum TwoQueuePolicy::selectVictim() {
+	if (a1in.empty() && am.empty()) return this->numberOfFrames;
+
+	if (a1in.size() > inLimit || am.empty()) {
+		return a1in.front();
+	}
+
+	while (true) { //Sat nad Am
+		PageNum frame = am.front();
+
+		if (!referenced[frame]) return frame;
+
+		referenced[frame] = false;
+		am.splice(am.end(), am, entries[frame]);
+	}
+}
+
+void TwoQueuePolicy::pageEvicted(PageNum frame) {
+	if (queue[frame] == QueueType::A1_IN) {
+		auto old = a1outMap.find(keys[frame]); //Kljuc moze ostati u A1out ako je stranica u medjuvremenu obrisana i ponovo kreirana
+		if (old != a1outMap.end()) {
+			a1out.erase(old->second);
+			a1outMap.erase(old);
+		}
+
+		a1out.push_front(keys[frame]);
+		a1outMap.insert({ keys[frame], a1out.begin() });
+
+		if (a1out.size() > outLimit) {
+			a1outMap.erase(a1out.back());
+			a1out.pop_back();
+		}
+	}
+
+	this->frameFreed(frame);
+}
+
+void TwoQueuePolicy::frameFreed(PageNum frame) {
+	if (queue[frame] == QueueType::A1_IN) a1in.erase(entries[frame]);
+	else if (queue[frame] == QueueType::AM) am.erase(entries[frame]);
+
+	queue[frame] = QueueType::NONE;
+	referenced[frame] = false;
+}
+
+bool TwoQueuePolicy::isIdle(PageNum frame) const {
+	return !referenced[frame];
+}
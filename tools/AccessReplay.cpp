@@ -0,0 +1,294 @@
+//Ponovo izvrsava snimak poziva sistema (System::startRecording) nad novim sistemom i ispisuje brzinu i broj page fault-ova:
+//	accessReplay snimak.bin [frejmovi] [pmtStranice] [niti] [algoritam] [kesKB]
+//Sa niti = 0 sve dogadjaje izvrsava jedna nit, a sa niti = 1 svaka nit iz snimka dobija svoju nit, koje se smenjuju
+//tacno redom dogadjaja iz snimka. Algoritam zamene je clock, clockpro, arc, 2q ili lruk, a kesKB velicina
+//kesa kompresovanih stranica ispred particije u kilobajtima (SystemConfig::swapCacheSize).
+//Snimak se pre merenja ucitava u memoriju. Pristup koji je pri snimanju vratio PAGE_FAULT, page fault za istu adresu i ponovljeni
+//pristup izvrsavaju se kao jedan pristup, a page fault se poziva samo ako ga sistem u kome se snimak izvrsava vrati.
+#include "AccessRecorder.h"
+#include "System.h"
+#include "Process.h"
+#include "part.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct ReplayOp {
+	AccessTraceEvent event;
+	unsigned char type;
+	bool populate;
+	bool superpages;
+	unsigned int thread;
+	ProcessId pid;
+	unsigned int address; //Virtuelni adresni prostor je 24-bitni
+	unsigned int size; //Velicina segmenta, broj adresa ACCESS_BATCH dogadjaja ili ID klona
+	unsigned int index; //Prva adresa ACCESS_BATCH dogadjaja ili redni broj imena deljenog segmenta
+};
+
+struct ReplayState {
+	System* system;
+	std::unordered_map<ProcessId, Process*> processes; //Procesi po ID-ju iz snimka
+	std::vector<AccessRequest> requests;
+	std::vector<std::string> names;
+	std::vector<char> content; //Sadrzaj segmenata koji se ucitavaju, snimak ga ne cuva
+	unsigned long long accesses = 0;
+	unsigned long long traps = 0;
+	unsigned long long skipped = 0; //Dogadjaji procesa koji nije kreiran u snimku
+};
+
+static Process* findProcess(ReplayState& state, ProcessId pid) {
+	auto it = state.processes.find(pid);
+	if (it == state.processes.end()) {
+		state.skipped++;
+		return nullptr;
+	}
+	return it->second;
+}
+
+static void replayAccess(ReplayState& state, Process* process, VirtualAddress address, AccessType type) {
+	state.accesses++;
+
+	Status status = state.system->access(process->getProcessId(), address, type);
+	if (status == PAGE_FAULT) { //Page fault-ove broji sistem, zajedno sa onima iz accessBatch-a
+		status = process->pageFault(address);
+		if (status == OK) status = state.system->access(process->getProcessId(), address, type);
+	}
+
+	if (status != OK) state.traps++;
+}
+
+static void execute(ReplayState& state, const ReplayOp& op) {
+	Process* process = nullptr;
+
+	if (op.event != AccessTraceEvent::CREATE_PROCESS && op.event != AccessTraceEvent::PERIODIC_JOB) {
+		process = findProcess(state, op.pid);
+		if (process == nullptr) return;
+	}
+
+	switch (op.event) {
+	case AccessTraceEvent::ACCESS:
+	case AccessTraceEvent::ACCESS_PAGE_FAULT:
+	case AccessTraceEvent::ACCESS_TRAP:
+		replayAccess(state, process, op.address, (AccessType)op.type);
+		break;
+	case AccessTraceEvent::ACCESS_BATCH: {
+		AccessResult results[ACCESS_TRACE_MAX_BATCH];
+		state.accesses += op.size;
+		if (state.system->accessBatch(process->getProcessId(), &state.requests[op.index], op.size, results) != OK) state.traps++;
+		break;
+	}
+	case AccessTraceEvent::PAGE_FAULT:
+		process->pageFault(op.address);
+		break;
+	case AccessTraceEvent::PERIODIC_JOB:
+		state.system->periodicJob();
+		break;
+	case AccessTraceEvent::CREATE_PROCESS:
+		state.processes[op.pid] = state.system->createProcess();
+		break;
+	case AccessTraceEvent::DELETE_PROCESS:
+		state.processes.erase(op.pid);
+		delete process;
+		break;
+	case AccessTraceEvent::CLONE_PROCESS:
+		if (op.size != 0) {
+			Process* clone = state.system->cloneProcess(process->getProcessId());
+			if (clone != nullptr) state.processes[op.size] = clone;
+		}
+		break;
+	case AccessTraceEvent::CREATE_SEGMENT:
+		process->createSegment(op.address, op.size, (AccessType)op.type, op.populate, op.superpages);
+		break;
+	case AccessTraceEvent::LOAD_SEGMENT:
+		if (state.content.size() < (size_t)op.size * PAGE_SIZE) state.content.resize((size_t)op.size * PAGE_SIZE);
+		process->loadSegment(op.address, op.size, (AccessType)op.type, state.content.data());
+		break;
+	case AccessTraceEvent::DELETE_SEGMENT:
+		process->deleteSegment(op.address);
+		break;
+	case AccessTraceEvent::CREATE_SHARED_SEGMENT:
+		process->createSharedSegment(op.address, op.size, state.names[op.index].c_str(), (AccessType)op.type);
+		break;
+	case AccessTraceEvent::DISCONNECT_SHARED_SEGMENT:
+		process->disconnectSharedSegment(state.names[op.index].c_str());
+		break;
+	case AccessTraceEvent::DELETE_SHARED_SEGMENT:
+		process->deleteSharedSegment(state.names[op.index].c_str());
+		break;
+	default:
+		break;
+	}
+}
+
+//Ucitava snimak u ops. Ponovljeni pristup posle page fault-a se izbacuje, a brojaci snimka se racunaju po logickim pristupima.
+static bool load(const char* fileName, ReplayState& state, std::vector<ReplayOp>& ops, unsigned int& threads, unsigned long long& recordedFaults) {
+	AccessTraceReader reader;
+	if (!reader.open(fileName)) return false;
+
+	threads = reader.getHeader().threads;
+	ops.reserve(reader.getHeader().events);
+
+	struct PendingFault {
+		ProcessId pid;
+		VirtualAddress address;
+		int step; //1 posle pristupa koji je vratio PAGE_FAULT, 2 posle page fault-a za istu adresu
+	};
+	std::vector<PendingFault> pending(threads + 1, { 0, 0, 0 });
+
+	AccessTraceRecord record;
+	while (reader.next(record)) {
+		PendingFault& fault = pending[record.thread];
+		bool sameAddress = fault.pid == record.pid && fault.address == record.address;
+		int step = fault.step;
+		fault.step = 0;
+
+		if (step == 1 && record.event == AccessTraceEvent::PAGE_FAULT && sameAddress) {
+			if (record.status == OK) fault.step = 2;
+			continue;
+		}
+		if (step == 2 && record.event == AccessTraceEvent::ACCESS && sameAddress) continue;
+
+		ReplayOp op;
+		op.event = record.event;
+		op.type = (unsigned char)record.type;
+		op.populate = record.populate;
+		op.superpages = record.superpages;
+		op.thread = record.thread;
+		op.pid = record.pid;
+		op.address = (unsigned int)record.address;
+		op.size = (record.event == AccessTraceEvent::CLONE_PROCESS) ? record.newPid : (unsigned int)record.size;
+		op.index = 0;
+
+		if (record.event == AccessTraceEvent::ACCESS_PAGE_FAULT) {
+			recordedFaults++;
+			fault = { record.pid, record.address, 1 };
+		}
+		else if (record.event == AccessTraceEvent::ACCESS_BATCH) {
+			op.size = (unsigned int)record.requests.size();
+			op.index = (unsigned int)state.requests.size();
+			state.requests.insert(state.requests.end(), record.requests.begin(), record.requests.end());
+		}
+		else if (record.event >= AccessTraceEvent::CREATE_SHARED_SEGMENT) {
+			op.index = (unsigned int)state.names.size();
+			state.names.push_back(record.name);
+		}
+
+		ops.push_back(op);
+	}
+
+	return !reader.isCorrupt();
+}
+
+static bool setPolicy(const char* name, SystemConfig& config) {
+	static const struct { const char* name; ReplacementPolicyType type; } policies[] = {
+		{ "clock", CLOCK }, { "clockpro", CLOCK_PRO }, { "arc", ARC }, { "2q", TWO_QUEUE }, { "lruk", LRU_K }
+	};
+
+	for (const auto& policy : policies) {
+		if (std::strcmp(policy.name, name) == 0) {
+			config.replacementPolicy = policy.type;
+			return true;
+		}
+	}
+	return false;
+}
+
+static PhysicalAddress alignToPage(char* address) {
+	return (PhysicalAddress)(((size_t)address + PAGE_SIZE) / PAGE_SIZE * PAGE_SIZE);
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::fprintf(stderr, "Upotreba: %s snimak [frejmovi] [pmtStranice] [niti] [algoritam] [kesKB]\n", argv[0]);
+		return 2;
+	}
+
+	PageNum frames = (argc > 2) ? std::atol(argv[2]) : 10000;
+	PageNum pmtPages = (argc > 3) ? std::atol(argv[3]) : 3000;
+	bool threaded = (argc > 4) && std::atoi(argv[4]) != 0;
+
+	SystemConfig config;
+	if (argc > 5 && !setPolicy(argv[5], config)) {
+		std::fprintf(stderr, "GRESKA: nepoznat algoritam zamene %s\n", argv[5]);
+		return 2;
+	}
+	if (argc > 6) config.swapCacheSize = (size_t)std::atol(argv[6]) * 1024;
+
+	ReplayState state;
+	std::vector<ReplayOp> ops;
+	unsigned int threads = 0;
+	unsigned long long recordedFaults = 0;
+
+	if (!load(argv[1], state, ops, threads, recordedFaults)) {
+		std::fprintf(stderr, "GRESKA: snimak %s ne moze da se procita\n", argv[1]);
+		return 1;
+	}
+
+	unsigned long long recordedAccesses = 0;
+	for (const ReplayOp& op : ops) {
+		if (op.event == AccessTraceEvent::ACCESS_BATCH) recordedAccesses += op.size;
+		else if (op.event <= AccessTraceEvent::ACCESS_TRAP) recordedAccesses++;
+	}
+
+	Partition partition("p1.ini");
+	char* vmSpace = new char[(frames + 2) * PAGE_SIZE];
+	char* pmtSpace = new char[(pmtPages + 2) * PAGE_SIZE];
+
+	state.system = new System(alignToPage(vmSpace), frames, alignToPage(pmtSpace), pmtPages, &partition, config);
+
+	auto start = std::chrono::steady_clock::now();
+
+	if (!threaded) {
+		for (const ReplayOp& op : ops) execute(state, op);
+	}
+	else {
+		//Nit izvrsava svoj dogadjaj tek kad su izvrseni svi dogadjaji sa manjim rednim brojem
+		std::atomic<size_t> turn(0);
+		std::vector<std::thread> workers;
+
+		for (unsigned int thread = 1; thread <= threads; thread++) {
+			workers.emplace_back([&, thread] {
+				for (size_t i = 0; i < ops.size(); i++) {
+					if (ops[i].thread != thread) continue;
+
+					while (turn.load(std::memory_order_acquire) != i) std::this_thread::yield();
+
+					execute(state, ops[i]);
+
+					turn.store(i + 1, std::memory_order_release);
+				}
+			});
+		}
+
+		for (std::thread& worker : workers) worker.join();
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	SystemStats stats = state.system->getStats();
+
+	for (auto& it : state.processes) delete it.second;
+	delete state.system;
+	delete[] vmSpace;
+	delete[] pmtSpace;
+
+	std::printf("dogadjaji: %zu, niti u snimku: %u, %s\n", ops.size(), threads, threaded ? "svaka nit snimka u svojoj niti" : "jedna nit");
+	std::printf("vreme: %.3f s, %.1f ns po dogadjaju, %.0f pristupa u sekundi\n", seconds, seconds * 1e9 / (ops.empty() ? 1 : ops.size()), state.accesses / seconds);
+	std::printf("pristupi: %llu, page fault: %lu (%.3f%%), TRAP: %llu, preskoceni dogadjaji: %llu\n", state.accesses, stats.faults,
+		100.0 * stats.faults / (state.accesses ? state.accesses : 1), state.traps, state.skipped);
+	std::printf("pri snimanju: pristupi: %llu, page fault bez accessBatch-a: %llu (%.3f%%)\n", recordedAccesses, recordedFaults, 100.0 * recordedFaults / (recordedAccesses ? recordedAccesses : 1));
+	std::printf("izbacene stranice: %lu (%lu modifikovanih), procitani klasteri: %lu, upisani klasteri: %lu\n", stats.evictions, stats.dirtyEvictions, stats.clusterReads, stats.clusterWrites);
+
+	if (stats.swapCache.capacity > 0) {
+		const SwapCacheStats& cache = stats.swapCache;
+		std::printf("kes: %lu stranica u %zu od %zu bajtova, upisi u kes: %lu, nekompresovane: %lu, pogoci: %lu, promasaji: %lu, upisi iz kesa na disk: %lu\n",
+			(unsigned long)cache.pages, cache.bytes, cache.capacity, cache.stores, cache.rejected, cache.hits, cache.misses, cache.writebacks);
+	}
+
+	return 0;
+}
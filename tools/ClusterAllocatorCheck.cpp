@@ -0,0 +1,101 @@
+//Provera alokatora klastera, vraca 0 ako su sve provere prosle:
+//	g++ -std=c++14 -O2 -Ih -Ipart tools/ClusterAllocatorCheck.cpp src/ClusterAllocator.cpp -o clusterAllocatorCheck
+//Proverava spajanje oslobodjenih nizova sa susedima, izbor najmanjeg dovoljno velikog ekstenta i MemoryException
+//pri dvostrukom oslobadjanju, oslobadjanju klastera van particije i trazenju niza koji ne postoji.
+#include "ClusterAllocator.h"
+#include "MemoryException.h"
+#include <cstdio>
+
+#define CLUSTERS 1000
+
+static unsigned long failures = 0;
+
+static void check(bool condition, const char* what) {
+	if (condition) return;
+
+	std::printf("GRESKA: %s\n", what);
+	++failures;
+}
+
+template <typename Operation>
+static bool throws(Operation operation) {
+	try {
+		operation();
+	}
+	catch (MemoryException&) {
+		return true;
+	}
+	return false;
+}
+
+static void checkCoalescing() {
+	ClusterAllocator allocator(CLUSTERS);
+
+	ClusterNo a = allocator.allocateRun(10), b = allocator.allocateRun(20), c = allocator.allocateRun(30);
+	check(a == 0 && b == 10 && c == 30, "nizovi iz praznog alokatora nisu susedni");
+	check(allocator.getNumberOfExtents() == 1 && allocator.getFreeClusters() == CLUSTERS - 60, "ostatak particije nije jedan ekstent");
+
+	allocator.freeRun(a, 10);
+	check(allocator.getNumberOfExtents() == 2, "oslobodjen niz bez slobodnih suseda nije poseban ekstent");
+
+	allocator.freeRun(c, 30); //Spaja se sa ostatkom particije
+	check(allocator.getNumberOfExtents() == 2 && allocator.getLargestRun() == CLUSTERS - 30, "niz nije spojen sa sledecim ekstentom");
+
+	allocator.freeRun(b, 20); //Spaja se sa oba suseda
+	check(allocator.getNumberOfExtents() == 1 && allocator.getLargestRun() == CLUSTERS, "niz nije spojen sa oba suseda");
+	check(allocator.getFreeClusters() == CLUSTERS, "broj slobodnih klastera nije ispravan posle oslobadjanja");
+
+	//Pojedinacni klasteri oslobodjeni obrnutim redom se spajaju sa prethodnim ekstentom
+	for (int i = 0; i < 100; i++) allocator.allocate();
+	for (ClusterNo i = 100; i > 0; i--) allocator.free(i - 1);
+	check(allocator.getNumberOfExtents() == 1 && allocator.getFreeClusters() == CLUSTERS, "pojedinacni klasteri nisu spojeni");
+}
+
+static void checkBestFit() {
+	ClusterAllocator allocator(CLUSTERS);
+
+	//Slobodni ekstenti od 50, 5 i 20 klastera, razdvojeni alociranim klasterima
+	allocator.allocateRun(CLUSTERS);
+	allocator.freeRun(0, 50);
+	allocator.freeRun(100, 5);
+	allocator.freeRun(200, 20);
+
+	check(allocator.allocateRun(5) == 100, "niz od 5 klastera nije uzet iz ekstenta iste velicine");
+	check(allocator.allocateRun(10) == 200, "niz od 10 klastera nije uzet iz najmanjeg dovoljnog ekstenta");
+	check(allocator.allocate() == 0, "pojedinacni klaster nije prvi slobodan");
+	check(allocator.getLargestRun() == 49, "najveci niz nije ispravan");
+	check(throws([&]() { allocator.allocateRun(50); }), "niz veci od najveceg ekstenta nije odbijen");
+	check(throws([&]() { allocator.allocateRun(0); }), "niz od 0 klastera nije odbijen");
+}
+
+static void checkInvalidFree() {
+	ClusterAllocator allocator(CLUSTERS);
+
+	ClusterNo first = allocator.allocateRun(100);
+	allocator.freeRun(first + 40, 20);
+
+	check(throws([&]() { allocator.freeRun(first + 40, 20); }), "dvostruko oslobadjanje niza nije prijavljeno");
+	check(throws([&]() { allocator.free(first + 50); }), "dvostruko oslobadjanje klastera nije prijavljeno");
+	check(throws([&]() { allocator.freeRun(first + 30, 20); }), "niz koji se zavrsava slobodnim klasterima nije prijavljen");
+	check(throws([&]() { allocator.freeRun(first + 50, 20); }), "niz koji pocinje slobodnim klasterima nije prijavljen");
+	check(throws([&]() { allocator.freeRun(first + 30, 40); }), "niz koji sadrzi slobodan ekstent nije prijavljen");
+	check(throws([&]() { allocator.free(CLUSTERS); }), "klaster van particije nije prijavljen");
+	check(throws([&]() { allocator.freeRun(CLUSTERS - 10, 20); }), "niz koji izlazi van particije nije prijavljen");
+
+	//Odbijena oslobadjanja ne menjaju stanje alokatora
+	check(allocator.getFreeClusters() == CLUSTERS - 80 && allocator.getNumberOfExtents() == 2, "odbijeno oslobadjanje je promenilo alokator");
+}
+
+int main() {
+	checkCoalescing();
+	checkBestFit();
+	checkInvalidFree();
+
+	if (failures > 0) {
+		std::printf("neuspelih provera: %lu\n", failures);
+		return 1;
+	}
+
+	std::printf("sve provere su prosle\n");
+	return 0;
+}
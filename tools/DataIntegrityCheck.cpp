@@ -0,0 +1,169 @@
+//Provera da stranice procesa zadrzavaju sadrzaj, vraca 0 ako su sve provere prosle:
+//	g++ -std=c++14 -O2 -Ih -Ipart tools/DataIntegrityCheck.cpp src/*.cpp part/part.cpp -pthread -o dataIntegrityCheck
+//	dataIntegrityCheck [p1.ini]
+//Svaki upis stavlja poznatu vrednost na mesto u stranici koje zavisi od prolaza, a cela stranica se cita nazad preko
+//getPhysicalAddress i poredi sa kopijom sadrzaja, pa se vidi i gubitak ranijih upisa. Stranice koje nisu upisane su nule.
+//Proces ima vise stranica nego sto ima frejmova, pa se stranice izbacuju i ucitavaju sa susednim stranicama, a deo segmenta
+//je preslikan velikim stranicama koje kloniranje deli na obicne. Klon i klon klona zatim menjaju deljene stranice.
+//Sve se radi jednom bez kesa kompresovanih stranica i jednom sa kesom.
+#include "System.h"
+#include "Process.h"
+#include "part.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define CHECK_FRAMES 512 //Cetiri poravnata niza za veliku stranicu
+#define CHECK_PMT_PAGES 256
+#define CHECK_PAGES 768 //Stranice obicnog segmenta, vise nego frejmova
+#define CHECK_SUPERPAGES 2
+#define CHECK_SUPERPAGE_BASE ((VirtualAddress)64 << PMT1_OFFSET) //Pocetak segmenta sa velikim stranicama, poravnat na ulaz PMT1
+
+static unsigned long failures = 0;
+
+static void check(bool condition, const char* what, unsigned long value) {
+	if (condition) return;
+
+	std::printf("GRESKA: %s (%lu)\n", what, value);
+	++failures;
+}
+
+//Vrednost koju upisuje proces owner u stranicu page u prolazu round
+static unsigned long pageValue(unsigned long owner, VirtualAddress page, unsigned long round) {
+	unsigned long long value = ((unsigned long long)owner << 48) ^ ((unsigned long long)round << 32) ^ page;
+	value *= 0x9E3779B97F4A7C15ULL;
+	return (unsigned long)(value >> 16) | 1;
+}
+
+//Upis u izbacenu stranicu koju proces deli sa klonom izaziva dva page fault-a, prvi ucitava stranicu, a drugi je kopira
+static char* touch(System& system, Process* process, VirtualAddress address, AccessType type) {
+	for (int attempt = 0; attempt < 3; attempt++) {
+		Status status = system.access(process->getProcessId(), address, type);
+
+		if (status == OK) return (char*)process->getPhysicalAddress(address);
+		if (status == TRAP || process->pageFault(address) != OK) break;
+	}
+
+	check(false, "pristup stranici nije uspeo", address);
+	return nullptr;
+}
+
+//Proces i ocekivani sadrzaj stranica oba segmenta, redom kao u pages
+struct CheckedProcess {
+	Process* process;
+	std::vector<char> expected;
+};
+
+static std::vector<VirtualAddress> pages;
+
+static void writePages(System& system, CheckedProcess& checked, unsigned long owner, unsigned long round, unsigned long step) {
+	size_t offset = (round * 136) % (PAGE_SIZE - sizeof(unsigned long)); //Ostatak stranice zadrzava vrednosti ranijih prolaza
+
+	for (size_t i = 0; i < pages.size(); i += step) {
+		char* address = touch(system, checked.process, pages[i], WRITE);
+		if (address == nullptr) continue;
+
+		unsigned long value = pageValue(owner, pages[i], round);
+		std::memcpy(address + offset, &value, sizeof(value));
+		std::memcpy(&checked.expected[i * PAGE_SIZE + offset], &value, sizeof(value));
+	}
+}
+
+static void checkPages(System& system, const CheckedProcess& checked, const char* what) {
+	unsigned long wrong = 0;
+
+	for (size_t i = 0; i < pages.size(); i++) {
+		char* address = touch(system, checked.process, pages[i], READ);
+		if (address == nullptr) continue;
+
+		if (std::memcmp(address, &checked.expected[i * PAGE_SIZE], PAGE_SIZE) != 0) ++wrong;
+	}
+
+	check(wrong == 0, what, wrong);
+}
+
+static void run(Partition* partition, size_t swapCacheSize) {
+	std::vector<char> vmSpace((CHECK_FRAMES + 1) * PAGE_SIZE), pmtSpace((CHECK_PMT_PAGES + 1) * PAGE_SIZE);
+
+	PhysicalAddress vm = (PhysicalAddress)(((size_t)vmSpace.data() + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE);
+	PhysicalAddress pmt = (PhysicalAddress)(((size_t)pmtSpace.data() + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE);
+
+	SystemConfig config;
+	config.swapCacheSize = swapCacheSize;
+
+	System system(vm, CHECK_FRAMES, pmt, CHECK_PMT_PAGES, partition, config);
+
+	CheckedProcess parent = { system.createProcess(), std::vector<char>(pages.size() * PAGE_SIZE, 0) };
+
+	check(parent.process->createSegment(0, CHECK_PAGES, READ_WRITE) == OK, "segment ne moze da se kreira", CHECK_PAGES);
+	check(parent.process->createSegment(CHECK_SUPERPAGE_BASE, CHECK_SUPERPAGES * SUPERPAGE_SIZE, READ_WRITE, false, true) == OK,
+		"segment sa velikim stranicama ne moze da se kreira", CHECK_SUPERPAGES);
+
+	//Stranice dobijaju frejm sa nulama pri prvom pristupu, a procitane stranice se izbacuju bez upisa na disk
+	checkPages(system, parent, "stranica koja nije upisana nije prazna");
+
+	//Upis u sve stranice izbacuje prethodno upisane, a citanje redom ih ucitava zajedno sa susednim izbacenim stranicama
+	writePages(system, parent, 0, 1, 1);
+	writePages(system, parent, 0, 2, 1);
+	checkPages(system, parent, "izbacena stranica je promenjena");
+
+	//Kloniranje deli velike stranice roditelja na obicne, a klonovi dele stranice sa roditeljem dok ih ne promene
+	CheckedProcess child = { system.cloneProcess(parent.process->getProcessId()), parent.expected };
+	check(child.process != nullptr, "proces ne moze da se klonira", 1);
+	if (child.process == nullptr) return;
+
+	checkPages(system, child, "klon ne vidi stranice roditelja");
+
+	writePages(system, child, 1, 3, 2);
+	writePages(system, parent, 0, 4, 3);
+
+	CheckedProcess grandchild = { system.cloneProcess(child.process->getProcessId()), child.expected };
+	check(grandchild.process != nullptr, "klon ne moze da se klonira", 2);
+	if (grandchild.process == nullptr) return;
+
+	writePages(system, grandchild, 2, 5, 5);
+
+	checkPages(system, parent, "upis klona je promenio stranicu roditelja");
+	checkPages(system, child, "klon ne vidi svoje stranice");
+	checkPages(system, grandchild, "klon klona ne vidi svoje stranice");
+
+	//Brisanje klona izmedju roditelja i klona klona ne sme da promeni stranice koje su oni delili sa njim
+	delete child.process;
+
+	checkPages(system, parent, "stranica roditelja je promenjena brisanjem klona");
+	checkPages(system, grandchild, "stranica klona klona je promenjena brisanjem klona");
+
+	SystemStats stats = system.getStats();
+	PrefetchStats prefetch = system.getPrefetchStats();
+
+	std::printf("kes %zu KB: izbacivanja %lu, citanja klastera %lu, ucitane unapred %lu, pogoci kesa %lu\n", swapCacheSize / 1024,
+		stats.evictions, stats.clusterReads, prefetch.prefetched, stats.swapCache.hits);
+
+	check(stats.evictions > 0, "nijedna stranica nije izbacena", 0);
+	check(prefetch.prefetched > 0, "nijedna stranica nije ucitana unapred", 0);
+	check(swapCacheSize == 0 || stats.swapCache.hits > 0, "nijedna stranica nije procitana iz kesa", 0);
+
+	delete grandchild.process;
+	delete parent.process;
+
+	stats = system.getStats();
+	check(stats.freeClusters == stats.totalClusters, "klasteri obrisanih procesa nisu oslobodjeni", stats.totalClusters - stats.freeClusters);
+}
+
+int main(int argc, char** argv) {
+	Partition partition((argc > 1) ? argv[1] : "p1.ini");
+
+	for (PageNum i = 0; i < CHECK_PAGES; i++) pages.push_back(i * PAGE_SIZE);
+	for (PageNum i = 0; i < CHECK_SUPERPAGES * SUPERPAGE_SIZE; i++) pages.push_back(CHECK_SUPERPAGE_BASE + i * PAGE_SIZE);
+
+	run(&partition, 0);
+	run(&partition, 64 * PAGE_SIZE);
+
+	if (failures > 0) {
+		std::printf("neuspelih provera: %lu\n", failures);
+		return 1;
+	}
+
+	std::printf("sve provere su prosle\n");
+	return 0;
+}
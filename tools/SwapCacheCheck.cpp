@@ -0,0 +1,177 @@
+//Provera kompresije stranica i kesa kompresovanih stranica, vraca 0 ako su sve provere prosle:
+//	g++ -std=c++14 -O2 -Ih -Ipart tools/SwapCacheCheck.cpp src/*.cpp part/part.cpp -pthread -o swapCacheCheck
+//	swapCacheCheck [p1.ini]
+//Stranice sa nulama, slucajnim bajtovima, kratkim ponavljanjem i poklapanjima koja se preklapaju sa sobom se kompresuju
+//i dekompresuju i porede bajt po bajt, a svaki skraceni ulaz mora da vrati false. Zatim proces kroz sistem sa malim kesom
+//upisuje i cita vise stranica nego sto ima frejmova, pa stranice prolaze kroz upis u kes, upis iz kesa na disk i citanje.
+#include "PageCompressor.h"
+#include "System.h"
+#include "Process.h"
+#include "part.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define CACHE_PAGES 256 //Stranice segmenta procesa, cetiri puta vise nego frejmova
+#define CACHE_FRAMES 64
+
+static unsigned long failures = 0;
+
+static void check(bool condition, const char* what, unsigned long value) {
+	if (condition) return;
+
+	std::printf("GRESKA: %s (%lu)\n", what, value);
+	++failures;
+}
+
+static unsigned long long seed = 88172645463325252ULL;
+
+static unsigned char randomByte() { //xorshift, isti sadrzaj pri svakom pokretanju
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (unsigned char)(seed >> 32);
+}
+
+//Stranica vrste kind, a broj number menja sadrzaj stranice iste vrste
+static void fillPage(char* page, int kind, unsigned long number) {
+	switch (kind) {
+	case 0: //Nule
+		std::memset(page, 0, PAGE_SIZE);
+		break;
+
+	case 1: //Slucajni bajtovi, ne kompresuje se
+		for (unsigned long i = 0; i < PAGE_SIZE; i++) page[i] = (char)randomByte();
+		break;
+
+	case 2: //Kratak niz koji se ponavlja, poklapanja na rastojanju manjem od duzine poklapanja
+		for (unsigned long i = 0; i < PAGE_SIZE; i++) page[i] = (char)("abcdefg"[i % 7] + number);
+		break;
+
+	default: //Slucajni delovi, nizovi istog bajta i kopije ranijih delova na razlicitim rastojanjima
+		for (unsigned long i = 0; i < PAGE_SIZE; ) {
+			unsigned long length = 1 + randomByte() % 40;
+			int mode = randomByte() % 4;
+
+			for (unsigned long j = 0; j < length && i < PAGE_SIZE; j++, i++) {
+				if (mode == 0 || i < 64) page[i] = (char)randomByte();
+				else if (mode == 1) page[i] = (char)number;
+				else if (mode == 2) page[i] = page[i - 1 - (number % 3)];
+				else page[i] = page[i - 64];
+			}
+		}
+		break;
+	}
+}
+
+static void checkCompressor() {
+	static const char* kinds[] = { "nule", "slucajni bajtovi", "ponavljanje", "preklapanje" };
+
+	std::vector<char> page(PAGE_SIZE), output(PAGE_SIZE * 2), result(PAGE_SIZE);
+
+	for (int kind = 0; kind < 4; kind++) {
+		size_t smallest = PAGE_SIZE * 2, largest = 0;
+
+		for (unsigned long number = 0; number < 200; number++) {
+			fillPage(page.data(), kind, number);
+
+			//Limit u koji staje i stranica koja se ne kompresuje
+			size_t size = PageCompressor::compress(page.data(), output.data(), output.size());
+			check(size > 0 && size <= output.size(), "kompresija stranice nije uspela", number);
+			if (size == 0) continue;
+
+			if (size < smallest) smallest = size;
+			if (size > largest) largest = size;
+
+			check(PageCompressor::decompress(output.data(), size, result.data()), "dekompresija nije uspela", number);
+			check(std::memcmp(page.data(), result.data(), PAGE_SIZE) == 0, "dekompresovana stranica se razlikuje od originala", number);
+
+			for (size_t prefix = 0; prefix < size; prefix++) {
+				check(!PageCompressor::decompress(output.data(), prefix, result.data()), "skracen ulaz je dekompresovan", prefix);
+			}
+
+			//Stranica koja ne staje u limit kesa se odbija, a ne skracuje
+			size_t limited = PageCompressor::compress(page.data(), output.data(), SWAP_CACHE_MAX_COMPRESSED_SIZE);
+			check(limited == 0 || limited <= SWAP_CACHE_MAX_COMPRESSED_SIZE, "kompresovana stranica je veca od limita", limited);
+			if (limited > 0) {
+				check(PageCompressor::decompress(output.data(), limited, result.data()) && std::memcmp(page.data(), result.data(), PAGE_SIZE) == 0,
+					"stranica kompresovana u limit kesa se razlikuje od originala", number);
+			}
+		}
+
+		std::printf("%s: kompresovano %zu - %zu bajtova\n", kinds[kind], smallest, largest);
+	}
+}
+
+static char* touch(System& system, Process* process, VirtualAddress address, AccessType type) {
+	for (int attempt = 0; attempt < 2; attempt++) {
+		Status status = system.access(process->getProcessId(), address, type);
+
+		if (status == OK) return (char*)process->getPhysicalAddress(address);
+		if (status == TRAP || process->pageFault(address) != OK) break;
+	}
+
+	check(false, "pristup stranici nije uspeo", address);
+	return nullptr;
+}
+
+static void checkCache(Partition* partition) {
+	std::vector<char> vmSpace((CACHE_FRAMES + 1) * PAGE_SIZE), pmtSpace(65 * PAGE_SIZE), expected(CACHE_PAGES * PAGE_SIZE);
+
+	PhysicalAddress vm = (PhysicalAddress)(((size_t)vmSpace.data() + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE);
+	PhysicalAddress pmt = (PhysicalAddress)(((size_t)pmtSpace.data() + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE);
+
+	SystemConfig config;
+	config.swapCacheSize = 16 * PAGE_SIZE; //Manje od stranica koje se izbacuju, pa se kes stalno upisuje na disk
+	config.swapCacheWritebackBatch = 8;
+
+	System system(vm, CACHE_FRAMES, pmt, 64, partition, config);
+	Process* process = system.createProcess();
+
+	check(process->createSegment(0, CACHE_PAGES, READ_WRITE) == OK, "segment ne moze da se kreira", CACHE_PAGES);
+
+	//Svaki prolaz menja sve stranice, pa se stari sadrzaj klastera i stranice u kesu zamenjuju novim
+	for (unsigned long round = 0; round < 4; round++) {
+		for (unsigned long i = 0; i < CACHE_PAGES; i++) {
+			char* address = touch(system, process, i * PAGE_SIZE, WRITE);
+			if (address == nullptr) continue;
+
+			fillPage(&expected[i * PAGE_SIZE], (i + round) % 4, i + round);
+			std::memcpy(address, &expected[i * PAGE_SIZE], PAGE_SIZE);
+		}
+
+		for (unsigned long i = 0; i < CACHE_PAGES; i++) {
+			char* address = touch(system, process, i * PAGE_SIZE, READ);
+			if (address == nullptr) continue;
+
+			check(std::memcmp(&expected[i * PAGE_SIZE], address, PAGE_SIZE) == 0, "procitana stranica se razlikuje od upisane", i);
+		}
+	}
+
+	SystemStats stats = system.getStats();
+	std::printf("kes: upisi %lu, nekompresovane %lu, pogoci %lu, promasaji %lu, upisi na disk %lu\n", stats.swapCache.stores,
+		stats.swapCache.rejected, stats.swapCache.hits, stats.swapCache.misses, stats.swapCache.writebacks);
+
+	check(stats.swapCache.stores > 0, "nijedna stranica nije upisana u kes", 0);
+	check(stats.swapCache.rejected > 0, "nijedna stranica nije odbijena", 0);
+	check(stats.swapCache.hits > 0, "nijedna stranica nije procitana iz kesa", 0);
+	check(stats.swapCache.writebacks > 0, "nijedna stranica nije upisana iz kesa na disk", 0);
+	check(stats.swapCache.bytes <= stats.swapCache.capacity, "kes je veci od zadate velicine", stats.swapCache.bytes);
+
+	delete process;
+}
+
+int main(int argc, char** argv) {
+	Partition partition((argc > 1) ? argv[1] : "p1.ini");
+
+	checkCompressor();
+	checkCache(&partition);
+
+	if (failures > 0) {
+		std::printf("neuspelih provera: %lu\n", failures);
+		return 1;
+	}
+
+	std::printf("sve provere su prosle\n");
+	return 0;
+}
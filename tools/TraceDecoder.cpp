@@ -0,0 +1,62 @@
+//Ispisuje tragove koje je upisao Trace::dump, jedan dogadjaj po liniji:
+//	traceDecoder trace.bin [nivo]
+//Sa zadatim nivoom (1 greske, 2 info, 3 debug) ispisuju se samo dogadjaji do tog nivoa.
+#include "Trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char* levelName(int level) {
+	return (level == TRACE_LEVEL_ERROR) ? "ERROR" : (level == TRACE_LEVEL_INFO) ? "INFO " : "DEBUG";
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::fprintf(stderr, "Upotreba: %s fajl [nivo]\n", argv[0]);
+		return 2;
+	}
+
+	int maxLevel = (argc > 2) ? std::atoi(argv[2]) : TRACE_LEVEL_DEBUG;
+
+	FILE* file = std::fopen(argv[1], "rb");
+	if (file == nullptr) {
+		std::fprintf(stderr, "GRESKA: fajl %s ne moze da se otvori\n", argv[1]);
+		return 1;
+	}
+
+	TraceFileHeader header;
+	if (std::fread(&header, sizeof(header), 1, file) != 1 || std::memcmp(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+		header.recordSize != sizeof(TraceRecord)) {
+		std::fprintf(stderr, "GRESKA: %s nije fajl sa tragovima ove verzije\n", argv[1]);
+		std::fclose(file);
+		return 1;
+	}
+
+	std::printf("%llu dogadjaja, %u niti, %llu prepisanih dogadjaja\n", header.records, header.threads, header.lost);
+
+	TraceRecord record;
+	unsigned long long start = 0;
+
+	for (unsigned long long i = 0; i < header.records && std::fread(&record, sizeof(record), 1, file) == 1; i++) {
+		if (i == 0) start = record.time; //Vreme se ispisuje od prvog dogadjaja u fajlu
+
+		if ((unsigned short)record.event >= (unsigned short)TraceEvent::EVENT_COUNT) {
+			std::printf("%14.3f us | nit %u | nepoznat dogadjaj %u\n", (record.time - start) / 1000.0, record.thread, (unsigned)record.event);
+			continue;
+		}
+
+		const TraceEventInfo& info = Trace::getEventInfo(record.event);
+		if (info.level > maxLevel) continue;
+
+		std::printf("%14.3f us | %s | nit %u | pid %u | %s", (record.time - start) / 1000.0, levelName(info.level), record.thread, record.pid, info.message);
+
+		for (int k = 0; k < 2; k++) {
+			if (info.args[k] != nullptr) std::printf(" | %s = %llu", info.args[k], record.args[k]);
+		}
+
+		std::printf("\n");
+	}
+
+	std::fclose(file);
+	return 0;
+}